@@ -136,7 +136,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 25,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    category = "player",
+                    mask = { "projectile" }
                 },
                 health = {
                     health_percentage = 100
@@ -263,7 +265,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 18,
-                    offset = { x = 0, y = 7 }
+                    offset = { x = 0, y = 7 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -295,7 +299,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 18,
-                    offset = { x = 7, y = 10 }
+                    offset = { x = 7, y = 10 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -327,7 +333,9 @@ Level = {
                 boxcollider = {
                     width = 20,
                     height = 18,
-                    offset = { x = 5, y = 7 }
+                    offset = { x = 5, y = 7 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -359,7 +367,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 18,
-                    offset = { x = 5, y = 7 }
+                    offset = { x = 5, y = 7 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -391,7 +401,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 18,
-                    offset = { x = 5, y = 7 }
+                    offset = { x = 5, y = 7 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -423,7 +435,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 18,
-                    offset = { x = 5, y = 7 }
+                    offset = { x = 5, y = 7 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -455,7 +469,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 18,
-                    offset = { x = 5, y = 7 }
+                    offset = { x = 5, y = 7 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -487,7 +503,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 18,
-                    offset = { x = 8, y = 6 }
+                    offset = { x = 8, y = 6 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -519,7 +537,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 18,
-                    offset = { x = 8, y = 6 }
+                    offset = { x = 8, y = 6 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -568,7 +588,9 @@ Level = {
                 boxcollider = {
                     width = 20,
                     height = 17,
-                    offset = { x = 7, y = 7 }
+                    offset = { x = 7, y = 7 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -600,7 +622,9 @@ Level = {
                 boxcollider = {
                     width = 18,
                     height = 20,
-                    offset = { x = 7, y = 7 }
+                    offset = { x = 7, y = 7 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -632,7 +656,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 18,
-                    offset = { x = 7, y = 7 }
+                    offset = { x = 7, y = 7 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -664,7 +690,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 18,
-                    offset = { x = 0, y = 7 }
+                    offset = { x = 0, y = 7 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -696,7 +724,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 20,
-                    offset = { x = 8, y = 4 }
+                    offset = { x = 8, y = 4 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -728,7 +758,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 20,
-                    offset = { x = 7, y = 8 }
+                    offset = { x = 7, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -760,7 +792,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 20,
-                    offset = { x = 7, y = 8 }
+                    offset = { x = 7, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -792,7 +826,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 20,
-                    offset = { x = 7, y = 8 }
+                    offset = { x = 7, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -824,7 +860,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 20,
-                    offset = { x = 7, y = 8 }
+                    offset = { x = 7, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -856,7 +894,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 20,
-                    offset = { x = 7, y = 8 }
+                    offset = { x = 7, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -888,7 +928,9 @@ Level = {
                 boxcollider = {
                     width = 22,
                     height = 18,
-                    offset = { x = 5, y = 7 }
+                    offset = { x = 5, y = 7 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -920,7 +962,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 18,
-                    offset = { x = 7, y = 7 }
+                    offset = { x = 7, y = 7 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -952,7 +996,9 @@ Level = {
                 boxcollider = {
                     width = 19,
                     height = 20,
-                    offset = { x = 6, y = 7 }
+                    offset = { x = 6, y = 7 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -984,7 +1030,9 @@ Level = {
                 boxcollider = {
                     width = 18,
                     height = 25,
-                    offset = { x = 7, y = 7 }
+                    offset = { x = 7, y = 7 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1016,7 +1064,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 20,
-                    offset = { x = 8, y = 4 }
+                    offset = { x = 8, y = 4 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1065,7 +1115,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 25,
-                    offset = { x = 10, y = 2 }
+                    offset = { x = 10, y = 2 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1090,7 +1142,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 25,
-                    offset = { x = 10, y = 2 }
+                    offset = { x = 10, y = 2 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1115,7 +1169,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 25,
-                    offset = { x = 10, y = 2 }
+                    offset = { x = 10, y = 2 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1140,7 +1196,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 25,
-                    offset = { x = 10, y = 2 }
+                    offset = { x = 10, y = 2 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1165,7 +1223,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 25,
-                    offset = { x = 10, y = 2 }
+                    offset = { x = 10, y = 2 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1190,7 +1250,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 25,
-                    offset = { x = 10, y = 2 }
+                    offset = { x = 10, y = 2 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1215,7 +1277,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 20,
-                    offset = { x = 10, y = 8 }
+                    offset = { x = 10, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1240,7 +1304,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 20,
-                    offset = { x = 10, y = 8 }
+                    offset = { x = 10, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1265,7 +1331,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 20,
-                    offset = { x = 10, y = 8 }
+                    offset = { x = 10, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1290,7 +1358,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 16,
-                    offset = { x = 3, y = 10 }
+                    offset = { x = 3, y = 10 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1315,7 +1385,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 16,
-                    offset = { x = 3, y = 10 }
+                    offset = { x = 3, y = 10 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1344,7 +1416,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1380,7 +1454,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1416,7 +1492,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1452,7 +1530,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1484,7 +1564,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1516,7 +1598,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1548,7 +1632,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1580,7 +1666,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1612,7 +1700,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1644,7 +1734,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2592,7 +2684,9 @@ Level = {
                 boxcollider = {
                     width = 20,
                     height = 25,
-                    offset = { x = 5, y = 5}
+                    offset = { x = 5, y = 5},
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2624,7 +2718,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 30,
-                    offset = { x = 5, y = 0 }
+                    offset = { x = 5, y = 0 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2653,7 +2749,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 32,
-                    offset = { x = 0, y = 0 }
+                    offset = { x = 0, y = 0 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2685,7 +2783,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 30,
-                    offset = { x = 0, y = 0 }
+                    offset = { x = 0, y = 0 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2779,7 +2879,9 @@ Level = {
                 },
                 boxcollider = {
                     width = 32,
-                    height = 32
+                    height = 32,
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2841,7 +2943,9 @@ Level = {
                 },
                 boxcollider = {
                     width = 32,
-                    height = 32
+                    height = 32,
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -119,7 +119,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 25,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    category = "player",
+                    mask = { "projectile" }
                 },
                 health = {
                     health_percentage = 100
@@ -346,7 +348,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -382,7 +386,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -418,7 +424,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -454,7 +462,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -490,7 +500,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -526,7 +538,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -562,7 +576,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -599,7 +615,9 @@ Level = {
                 boxcollider = {
                     width = 17,
                     height = 15,
-                    offset = { x = 8, y = 8 }
+                    offset = { x = 8, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -631,7 +649,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -663,7 +683,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -695,7 +717,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -727,7 +751,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -759,7 +785,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -791,7 +819,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -823,7 +853,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -855,7 +887,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -887,7 +921,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -919,7 +955,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 20,
-                    offset = { x = 10, y = 8 }
+                    offset = { x = 10, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -951,7 +989,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 20,
-                    offset = { x = 10, y = 8 }
+                    offset = { x = 10, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -983,7 +1023,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 20,
-                    offset = { x = 10, y = 8 }
+                    offset = { x = 10, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1015,7 +1057,9 @@ Level = {
                 boxcollider = {
                     width = 12,
                     height = 20,
-                    offset = { x = 10, y = 8 }
+                    offset = { x = 10, y = 8 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1047,7 +1091,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1079,7 +1125,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -1111,7 +1159,9 @@ Level = {
                 boxcollider = {
                     width = 30,
                     height = 20,
-                    offset = { x = 0, y = 5 }
+                    offset = { x = 0, y = 5 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2235,7 +2285,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 30,
-                    offset = { x = 5, y = 0 }
+                    offset = { x = 5, y = 0 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2267,7 +2319,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 30,
-                    offset = { x = 5, y = 0 }
+                    offset = { x = 5, y = 0 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2299,7 +2353,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 30,
-                    offset = { x = 5, y = 0 }
+                    offset = { x = 5, y = 0 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2331,7 +2387,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 30,
-                    offset = { x = 5, y = 0 }
+                    offset = { x = 5, y = 0 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2363,7 +2421,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 30,
-                    offset = { x = 5, y = 0 }
+                    offset = { x = 5, y = 0 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2392,7 +2452,9 @@ Level = {
                 boxcollider = {
                     width = 20,
                     height = 25,
-                    offset = { x = 5, y = 5}
+                    offset = { x = 5, y = 5},
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2421,7 +2483,9 @@ Level = {
                 boxcollider = {
                     width = 32,
                     height = 32,
-                    offset = { x = 0, y = 0 }
+                    offset = { x = 0, y = 0 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2453,7 +2517,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 30,
-                    offset = { x = 5, y = 0 }
+                    offset = { x = 5, y = 0 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2485,7 +2551,9 @@ Level = {
                 boxcollider = {
                     width = 25,
                     height = 30,
-                    offset = { x = 5, y = 0 }
+                    offset = { x = 5, y = 0 },
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2516,7 +2584,9 @@ Level = {
                 },
                 boxcollider = {
                     width = 32,
-                    height = 32
+                    height = 32,
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
@@ -2569,7 +2639,9 @@ Level = {
                 },
                 boxcollider = {
                     width = 32,
-                    height = 24
+                    height = 24,
+                    category = "enemy",
+                    mask = { "projectile", "obstacle" }
                 },
                 health = {
                     health_percentage = 100
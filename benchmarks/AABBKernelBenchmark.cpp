@@ -0,0 +1,67 @@
+// Batch AABB overlap kernel benchmark: scalar loop vs. the SIMD path the build selected.
+// One box is tested against a run of boxes at a time, as the broad phases do. Build and run with `make bench`.
+
+#include "../src/Physics/AABB.h"
+#include "../src/Physics/AABBBatch.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+const int NUM_BOXES = 4096;
+
+int main() {
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> position(0, 1024);
+    std::uniform_real_distribution<float> size(4, 64);
+
+    std::vector<AABB> boxes;
+    AABBBatch batch;
+    for (int i = 0; i < NUM_BOXES; i++) {
+        float x = position(random);
+        float y = position(random);
+        boxes.emplace_back(x, y, x + size(random), y + size(random));
+        batch.Add(boxes.back());
+    }
+
+    std::printf("SIMD path: %s\n", AABBBatch::GetInstructionSet());
+    std::printf("%10s %14s %14s %9s\n", "run length", "scalar pairs/s", "SIMD pairs/s", "speedup");
+
+    // Test every box against runs of the given length, as a cell or a sweep interval would hold
+    std::vector<int> scalarOverlaps;
+    std::vector<int> simdOverlaps;
+    for (size_t runLength: {4, 8, 16, 64, 256, 4096}) {
+        double pairsPerSecond[2];
+
+        for (int isSimd = 0; isSimd < 2; isSimd++) {
+            std::vector<int>& overlaps = isSimd ? simdOverlaps : scalarOverlaps;
+            long pairs = 0;
+            const auto start = std::chrono::steady_clock::now();
+            std::chrono::duration<double> elapsed(0);
+
+            while (elapsed.count() < 0.2) {
+                overlaps.clear();
+                for (size_t i = 0; i < boxes.size(); i++) {
+                    const size_t begin = (i * 7919) % (boxes.size() - runLength + 1);
+                    if (isSimd) {
+                        batch.FindOverlaps(boxes[i], begin, begin + runLength, overlaps);
+                    } else {
+                        batch.FindOverlapsScalar(boxes[i], begin, begin + runLength, overlaps);
+                    }
+                }
+                pairs += boxes.size() * runLength;
+                elapsed = std::chrono::steady_clock::now() - start;
+            }
+            pairsPerSecond[isSimd] = pairs / elapsed.count();
+        }
+
+        if (scalarOverlaps != simdOverlaps) {
+            std::printf("SIMD and scalar results differ at run length %zu\n", runLength);
+            return 1;
+        }
+
+        std::printf("%10zu %14.3g %14.3g %8.1fx\n", runLength, pairsPerSecond[0], pairsPerSecond[1], pairsPerSecond[1] / pairsPerSecond[0]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+// Collision broad phase benchmark: naive pair loop vs. spatial hash vs. sweep and prune.
+// Boxes are bullet to enemy sized, scattered over a map of 64x64 tiles, and drift a little
+// every frame like the level's tanks and trucks. Build and run with `make bench`.
+
+#include "../src/Physics/AABB.h"
+#include "../src/Physics/SpatialHash.h"
+#include "../src/Physics/SweepAndPrune.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+const float MAP_SIZE = 64 * 64;
+const float TILE_SIZE = 64;
+
+struct Scene {
+    std::vector<AABB> boxes;
+    std::vector<float> velocities;
+    std::vector<CollisionFilter> filters;
+    std::vector<int> ids;
+
+    Scene(int count, std::mt19937& random) {
+        std::uniform_real_distribution<float> position(0, MAP_SIZE);
+        std::uniform_real_distribution<float> size(4, 64);
+        std::uniform_real_distribution<float> velocity(-2, 2);
+
+        for (int i = 0; i < count; i++) {
+            float x = position(random);
+            float y = position(random);
+            boxes.emplace_back(x, y, x + size(random), y + size(random));
+            velocities.push_back(velocity(random));
+            filters.emplace_back();
+            ids.push_back(i);
+        }
+    }
+
+    // Move every box a couple of pixels along X, as one frame of slow traffic would
+    void Step() {
+        for (size_t i = 0; i < boxes.size(); i++) {
+            boxes[i].minX += velocities[i];
+            boxes[i].maxX += velocities[i];
+        }
+    }
+};
+
+int CountNaive(const std::vector<AABB>& boxes) {
+    int overlaps = 0;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        for (size_t j = i + 1; j < boxes.size(); j++) {
+            overlaps += boxes[i].Overlaps(boxes[j]);
+        }
+    }
+    return overlaps;
+}
+
+// Average milliseconds per frame over enough frames to run for about 200ms.
+// Every frame steps the scene and checks the result against the naive loop outside the timer.
+template <typename TFunc>
+double TimeMilliseconds(Scene& scene, TFunc&& func, bool& isCorrect) {
+    using Clock = std::chrono::steady_clock;
+    std::chrono::duration<double, std::milli> elapsed(0);
+    int frames = 0;
+
+    while (elapsed.count() < 200) {
+        scene.Step();
+        const auto start = Clock::now();
+        const int overlaps = func();
+        elapsed += Clock::now() - start;
+        frames++;
+
+        if (frames <= 3 && overlaps != CountNaive(scene.boxes)) {
+            isCorrect = false;
+        }
+    }
+    return elapsed.count() / frames;
+}
+
+int main() {
+    std::mt19937 random(1234);
+
+    std::printf("%9s %12s %12s %12s %14s %14s %14s\n", "entities", "naive ms", "hashed ms", "sap ms", "naive pairs/s", "hashed pairs/s", "sap pairs/s");
+
+    for (int count: {250, 500, 1000, 2000, 4000, 8000, 16000}) {
+        Scene scene(count, random);
+        SpatialHash spatialHash(TILE_SIZE);
+        SweepAndPrune sweepAndPrune;
+        bool isCorrect = true;
+
+        const double naiveMs = TimeMilliseconds(scene, [&]() {
+            return CountNaive(scene.boxes);
+        }, isCorrect);
+        const double hashedMs = TimeMilliseconds(scene, [&]() {
+            return static_cast<int>(spatialHash.FindOverlappingPairs(scene.boxes, scene.filters).size());
+        }, isCorrect);
+        const double sweepMs = TimeMilliseconds(scene, [&]() {
+            return static_cast<int>(sweepAndPrune.FindOverlappingPairs(scene.boxes, scene.filters, scene.ids).size());
+        }, isCorrect);
+
+        if (!isCorrect) {
+            std::printf("Broad phase results differ from the naive loop at %d entities\n", count);
+            return 1;
+        }
+
+        // Throughput in potential pairs (n * (n - 1) / 2) resolved per second
+        const double potentialPairs = count * (count - 1.0) / 2;
+        std::printf("%9d %12.3f %12.3f %12.3f %14.3g %14.3g %14.3g\n", count, naiveMs, hashedMs, sweepMs,
+            potentialPairs / naiveMs * 1000, potentialPairs / hashedMs * 1000, potentialPairs / sweepMs * 1000);
+    }
+
+    return 0;
+}
@@ -0,0 +1,387 @@
+// Collision event volume on a level: one event per overlapping pair per frame (the old behaviour)
+// vs. enter and exit events from persistent contact tracking.
+// The level's entities are read from its Lua file, then a headless simulation moves them, fires their
+// projectile emitters and applies projectile damage on contact. Scripted entities only run their
+// initial state, and the player never dies so the run covers the whole duration. The player stays
+// put and, standing in for the keyboard, fires at the nearest enemy twice a second; without that no
+// projectile would ever reach a collider its layers accept, and the layered run would have no contacts.
+// Build and run with `make bench`; pass another level file as the first argument.
+
+#include "../src/Physics/AABB.h"
+#include "../src/Physics/CollisionFilter.h"
+#include "../src/Physics/ContactTracker.h"
+#include "../src/Physics/SpatialHash.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+const int FRAMES_PER_SECOND = 60;
+const int NUM_FRAMES = 60 * FRAMES_PER_SECOND;
+const int PLAYER_FIRE_MS = 500;
+
+struct Body {
+    uint64_t key;
+    bool isAlive = true;
+    bool isPlayer = false;
+    bool isEnemy = false;
+    float x = 0, y = 0;
+    float velocityX = 0, velocityY = 0;
+    float centerX = 0, centerY = 0;
+
+    bool hasCollider = false;
+    float width = 0, height = 0, offsetX = 0, offsetY = 0;
+    CollisionFilter filter;
+    int health = 100;
+
+    // Projectile emitter
+    bool hasEmitter = false;
+    float emitVelocityX = 0, emitVelocityY = 0;
+    int repeatMs = 0, durationMs = 0, damage = 0, lastEmissionMs = 0;
+    bool isFriendly = false;
+
+    // Projectile
+    bool isProjectile = false;
+    int spawnMs = 0;
+};
+
+struct Level {
+    std::vector<Body> bodies;
+    float mapWidth = 0;
+    float mapHeight = 0;
+};
+
+// === Level file scanning === //
+// Level files are plain data tables, so a few patterns per component are enough to read them back
+
+const std::string NUMBER = R"((-?[0-9]+(?:\.[0-9]+)?))";
+
+bool FindNumbers(const std::string& text, const std::string& pattern, std::vector<float>& numbers) {
+    std::smatch match;
+    if (!std::regex_search(text, match, std::regex(pattern))) {
+        return false;
+    }
+    numbers.clear();
+    for (size_t i = 1; i < match.size(); i++) {
+        numbers.push_back(std::stof(match[i].str()));
+    }
+    return true;
+}
+
+// Body of the table assigned to name, including nested tables
+std::string FindTable(const std::string& text, const std::string& name) {
+    std::smatch match;
+    if (!std::regex_search(text, match, std::regex("\\b" + name + R"(\s*=\s*\{)"))) {
+        return "";
+    }
+    size_t begin = match.position(0) + match.length(0);
+    int depth = 1;
+    for (size_t i = begin; i < text.size(); i++) {
+        depth += (text[i] == '{') - (text[i] == '}');
+        if (depth == 0) {
+            return text.substr(begin, i - begin);
+        }
+    }
+    return "";
+}
+
+uint32_t ParseLayers(const std::string& collider, const std::string& name, uint32_t defaultLayers, bool useLayers) {
+    static const std::unordered_map<std::string, uint32_t> layersPerName = {
+        {"default", COLLISION_LAYER_DEFAULT}, {"player", COLLISION_LAYER_PLAYER}, {"enemy", COLLISION_LAYER_ENEMY},
+        {"projectile", COLLISION_LAYER_PROJECTILE}, {"obstacle", COLLISION_LAYER_OBSTACLE}, {"all", COLLISION_LAYER_ALL}
+    };
+
+    std::smatch match;
+    if (!useLayers || !std::regex_search(collider, match, std::regex("\\b" + name + R"(\s*=\s*(\{[^}]*\}|"\w+"))"))) {
+        return defaultLayers;
+    }
+
+    uint32_t layers = 0;
+    const std::string value = match[1].str();
+    const std::regex nameRegex("\"(\\w+)\"");
+    for (auto layer = std::sregex_iterator(value.begin(), value.end(), nameRegex); layer != std::sregex_iterator(); layer++) {
+        layers |= layersPerName.at((*layer)[1].str());
+    }
+    return layers;
+}
+
+bool LoadLevel(const std::string& filePath, bool useLayers, Level& level) {
+    std::ifstream file(filePath);
+    if (!file) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    // Drop comments so they can't confuse the patterns
+    const std::string text = std::regex_replace(buffer.str(), std::regex("--[^\n]*"), "");
+
+    std::vector<float> numbers;
+    const std::string tilemap = FindTable(text, "tilemap");
+    std::vector<float> mapValues;
+    for (const char* name: {"num_rows", "num_cols", "tile_size", "scale"}) {
+        FindNumbers(tilemap, std::string(name) + R"(\s*=\s*)" + NUMBER, numbers);
+        mapValues.push_back(numbers[0]);
+    }
+    level.mapHeight = mapValues[0] * mapValues[2] * mapValues[3];
+    level.mapWidth = mapValues[1] * mapValues[2] * mapValues[3];
+
+    // Split the entities table into one block per entity
+    const std::string entities = FindTable(text, "entities");
+    std::vector<std::string> blocks;
+    int depth = 0;
+    size_t blockBegin = 0;
+    for (size_t i = 0; i < entities.size(); i++) {
+        if (entities[i] == '{' && depth++ == 0) {
+            blockBegin = i + 1;
+        } else if (entities[i] == '}' && --depth == 0) {
+            blocks.push_back(entities.substr(blockBegin, i - blockBegin));
+        }
+    }
+
+    for (const auto& block: blocks) {
+        Body body;
+        body.key = level.bodies.size();
+        body.isPlayer = std::regex_search(block, std::regex(R"(\btag\s*=\s*"player")"));
+        body.isEnemy = std::regex_search(block, std::regex(R"(\bgroup\s*=\s*"enemies")"));
+
+        if (FindNumbers(block, R"(position\s*=\s*\{\s*x\s*=\s*)" + NUMBER + R"(\s*,\s*y\s*=\s*)" + NUMBER, numbers)) {
+            body.x = numbers[0];
+            body.y = numbers[1];
+        }
+        if (FindNumbers(FindTable(block, "rigidbody"), R"(velocity\s*=\s*\{\s*x\s*=\s*)" + NUMBER + R"(\s*,\s*y\s*=\s*)" + NUMBER, numbers)) {
+            body.velocityX = numbers[0];
+            body.velocityY = numbers[1];
+        }
+        if (FindNumbers(FindTable(block, "sprite"), R"(width\s*=\s*)" + NUMBER + R"(\s*,\s*height\s*=\s*)" + NUMBER, numbers)) {
+            body.centerX = numbers[0] / 2;
+            body.centerY = numbers[1] / 2;
+        }
+
+        const std::string collider = FindTable(block, "boxcollider");
+        if (!collider.empty()) {
+            body.hasCollider = true;
+            FindNumbers(collider, R"(width\s*=\s*)" + NUMBER, numbers);
+            body.width = numbers[0];
+            FindNumbers(collider, R"(height\s*=\s*)" + NUMBER, numbers);
+            body.height = numbers[0];
+            if (FindNumbers(collider, R"(offset\s*=\s*\{\s*x\s*=\s*)" + NUMBER + R"(\s*,\s*y\s*=\s*)" + NUMBER, numbers)) {
+                body.offsetX = numbers[0];
+                body.offsetY = numbers[1];
+            }
+            body.filter = CollisionFilter(
+                ParseLayers(collider, "category", COLLISION_LAYER_DEFAULT, useLayers),
+                ParseLayers(collider, "mask", COLLISION_LAYER_ALL, useLayers)
+            );
+        }
+
+        const std::string emitter = FindTable(block, "projectile_emitter");
+        if (!emitter.empty()) {
+            body.hasEmitter = true;
+            FindNumbers(emitter, R"(projectile_velocity\s*=\s*\{\s*x\s*=\s*)" + NUMBER + R"(\s*,\s*y\s*=\s*)" + NUMBER, numbers);
+            body.emitVelocityX = numbers[0];
+            body.emitVelocityY = numbers[1];
+            FindNumbers(emitter, R"(projectile_duration\s*=\s*)" + NUMBER, numbers);
+            body.durationMs = numbers[0] * 1000;
+            FindNumbers(emitter, R"(repeat_frequency\s*=\s*)" + NUMBER, numbers);
+            body.repeatMs = numbers[0] * 1000;
+            FindNumbers(emitter, R"(hit_percentage_damage\s*=\s*)" + NUMBER, numbers);
+            body.damage = numbers[0];
+            body.isFriendly = std::regex_search(emitter, std::regex(R"(friendly\s*=\s*true)"));
+        }
+
+        level.bodies.push_back(body);
+    }
+    return true;
+}
+
+// === Simulation === //
+
+struct EventCounts {
+    long perFrameEvents = 0;
+    long enterEvents = 0;
+    long exitEvents = 0;
+};
+
+Body SpawnProjectile(const Body& emitter, float velocityX, float velocityY, uint64_t key, int nowMs, bool useLayers) {
+    Body projectile;
+    projectile.key = key;
+    projectile.isProjectile = true;
+    projectile.isFriendly = emitter.isFriendly;
+    projectile.damage = emitter.damage;
+    projectile.spawnMs = nowMs;
+    projectile.durationMs = emitter.durationMs;
+    projectile.x = emitter.x + emitter.centerX;
+    projectile.y = emitter.y + emitter.centerY;
+    projectile.velocityX = velocityX;
+    projectile.velocityY = velocityY;
+    projectile.hasCollider = true;
+    projectile.width = projectile.height = 4;
+    if (useLayers) {
+        projectile.filter = CollisionFilter(COLLISION_LAYER_PROJECTILE, emitter.isFriendly ? COLLISION_LAYER_ENEMY : COLLISION_LAYER_PLAYER);
+    }
+    return projectile;
+}
+
+// Index of the living enemy closest to the body, or -1 if none is left
+int FindNearestEnemy(const Level& level, const Body& body) {
+    int nearest = -1;
+    float nearestDistance = 0;
+    for (size_t i = 0; i < level.bodies.size(); i++) {
+        const Body& enemy = level.bodies[i];
+        if (!enemy.isAlive || !enemy.isEnemy || !enemy.hasCollider) {
+            continue;
+        }
+        const float dx = enemy.x - body.x;
+        const float dy = enemy.y - body.y;
+        const float distance = dx * dx + dy * dy;
+        if (nearest == -1 || distance < nearestDistance) {
+            nearest = static_cast<int>(i);
+            nearestDistance = distance;
+        }
+    }
+    return nearest;
+}
+
+EventCounts Simulate(Level level, bool useLayers) {
+    EventCounts counts;
+    SpatialHash spatialHash(64);
+    ContactTracker contactTracker;
+    std::vector<AABB> boxes;
+    std::vector<CollisionFilter> filters;
+    std::vector<int> colliderBodies;
+    uint64_t nextKey = level.bodies.size();
+    const float deltaTime = 1.0f / FRAMES_PER_SECOND;
+
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        const int nowMs = frame * 1000 / FRAMES_PER_SECOND;
+
+        // Projectile emitters, lifecycle and movement
+        const size_t numBodies = level.bodies.size();
+        for (size_t i = 0; i < numBodies; i++) {
+            Body& body = level.bodies[i];
+            if (body.hasEmitter && body.repeatMs > 0 && nowMs - body.lastEmissionMs > body.repeatMs) {
+                body.lastEmissionMs = nowMs;
+                level.bodies.push_back(SpawnProjectile(body, body.emitVelocityX, body.emitVelocityY, nextKey++, nowMs, useLayers));
+            }
+        }
+
+        // The player's shots fly at the emitter's speed, aimed at the nearest enemy
+        for (size_t i = 0; i < numBodies; i++) {
+            Body& player = level.bodies[i];
+            if (!player.isPlayer || !player.hasEmitter || nowMs - player.lastEmissionMs < PLAYER_FIRE_MS) {
+                continue;
+            }
+            const int target = FindNearestEnemy(level, player);
+            if (target == -1) {
+                continue;
+            }
+            const Body& enemy = level.bodies[target];
+            const float dx = (enemy.x + enemy.offsetX + enemy.width / 2) - (player.x + player.centerX);
+            const float dy = (enemy.y + enemy.offsetY + enemy.height / 2) - (player.y + player.centerY);
+            const float distance = std::sqrt(dx * dx + dy * dy);
+            const float speed = std::sqrt(player.emitVelocityX * player.emitVelocityX + player.emitVelocityY * player.emitVelocityY);
+            if (distance > 0) {
+                player.lastEmissionMs = nowMs;
+                level.bodies.push_back(SpawnProjectile(player, dx / distance * speed, dy / distance * speed, nextKey++, nowMs, useLayers));
+            }
+        }
+
+        for (auto& body: level.bodies) {
+            if (body.isProjectile && nowMs - body.spawnMs > body.durationMs) {
+                body.isAlive = false;
+            }
+            body.x += body.velocityX * deltaTime;
+            body.y += body.velocityY * deltaTime;
+            if (!body.isPlayer && (body.x < 0 || body.x > level.mapWidth || body.y < 0 || body.y > level.mapHeight)) {
+                body.isAlive = false;
+            }
+        }
+
+        // Collisions
+        boxes.clear();
+        filters.clear();
+        colliderBodies.clear();
+        for (size_t i = 0; i < level.bodies.size(); i++) {
+            const Body& body = level.bodies[i];
+            if (body.isAlive && body.hasCollider) {
+                boxes.emplace_back(body.x + body.offsetX, body.y + body.offsetY, body.x + body.offsetX + body.width, body.y + body.offsetY + body.height);
+                filters.push_back(body.filter);
+                colliderBodies.push_back(static_cast<int>(i));
+            }
+        }
+
+        contactTracker.BeginFrame();
+        for (const auto& pair: spatialHash.FindOverlappingPairs(boxes, filters)) {
+            counts.perFrameEvents++;
+
+            Body& a = level.bodies[colliderBodies[pair.first]];
+            Body& b = level.bodies[colliderBodies[pair.second]];
+            if (!contactTracker.Touch(a.key, b.key)) {
+                continue;
+            }
+            counts.enterEvents++;
+
+            // Projectile damage, as in the DamageSystem
+            for (auto [projectile, target]: {std::make_pair(&a, &b), std::make_pair(&b, &a)}) {
+                if (!projectile->isProjectile) {
+                    continue;
+                }
+                if (projectile->isFriendly && target->isEnemy) {
+                    target->health -= projectile->damage;
+                    target->isAlive = target->health > 0;
+                    projectile->isAlive = false;
+                } else if (!projectile->isFriendly && target->isPlayer) {
+                    projectile->isAlive = false;
+                }
+            }
+        }
+        counts.exitEvents += contactTracker.EndFrame().size();
+
+        // Dead bodies leave at the end of the frame, like killed entities
+        size_t numAlive = 0;
+        for (auto& body: level.bodies) {
+            if (body.isAlive) {
+                level.bodies[numAlive++] = body;
+            }
+        }
+        level.bodies.resize(numAlive);
+    }
+
+    return counts;
+}
+
+int main(int argc, char* argv[]) {
+    const std::string levelFilePath = argc > 1 ? argv[1] : "./assets/scripts/Level1.lua";
+
+    std::printf("%s, %d frames\n", levelFilePath.c_str(), NUM_FRAMES);
+    std::printf("%-16s %18s %18s %10s\n", "collision layers", "per-frame events", "enter+exit events", "reduction");
+
+    for (bool useLayers: {false, true}) {
+        Level level;
+        if (!LoadLevel(levelFilePath, useLayers, level)) {
+            std::printf("Could not open %s\n", levelFilePath.c_str());
+            return 1;
+        }
+
+        const EventCounts counts = Simulate(level, useLayers);
+        const long contactEvents = counts.enterEvents + counts.exitEvents;
+        std::printf("%-16s %18ld %18ld", useLayers ? "on" : "off", counts.perFrameEvents, contactEvents);
+        if (contactEvents > 0) {
+            std::printf(" %9.1fx\n", static_cast<double>(counts.perFrameEvents) / contactEvents);
+        } else {
+            std::printf(" %10s\n", "-");
+        }
+    }
+
+    std::printf("Without layers most events are long overlaps: shots leaving the tank that fired them and\n");
+    std::printf("passing through other enemies, which contact tracking reports once instead of every frame.\n");
+    std::printf("Layers already filter those out; what's left are hits, and a projectile dies on its hit, so\n");
+    std::printf("each contact lasts one frame and costs an enter and an exit event instead of one event.\n");
+
+    return 0;
+}
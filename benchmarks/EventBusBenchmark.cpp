@@ -0,0 +1,191 @@
+// Event dispatch benchmark: emits per second through the EventBus vs. the previous bus, which
+// looked the handlers up in a std::map, walked a std::list of virtual callbacks and built the
+// event once per handler. A second table compares emitting with queuing the same events a frame
+// at a time and flushing them to batch handlers. Build and run with `make bench`.
+
+#include "../src/EventBus/EventBus.h"
+#include <chrono>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <memory>
+#include <typeindex>
+#include <vector>
+
+// === Previous bus, kept here as the baseline === //
+
+class LegacyEventCallbackBase {
+    private:
+        virtual void Call(Event& e) = 0;
+
+    public:
+        virtual ~LegacyEventCallbackBase() = default;
+
+        void Execute(Event& e) {
+            Call(e);
+        }
+};
+
+template <typename TOwner, typename TEvent>
+class LegacyEventCallback: public LegacyEventCallbackBase {
+    private:
+        typedef void (TOwner::*CallbackFunction)(TEvent&);
+
+        TOwner* ownerInstance;
+        CallbackFunction callbackFunction;
+
+        virtual void Call(Event& e) override {
+            std::invoke(callbackFunction, ownerInstance, static_cast<TEvent&>(e));
+        }
+
+    public:
+        LegacyEventCallback(TOwner* ownerInstance, CallbackFunction callbackFunction) {
+            this->ownerInstance = ownerInstance;
+            this->callbackFunction = callbackFunction;
+        }
+};
+
+class LegacyEventBus {
+    private:
+        std::map<std::type_index, std::unique_ptr<std::list<std::unique_ptr<LegacyEventCallbackBase>>>> subscribers;
+
+    public:
+        template <typename TEvent, typename TOwner>
+        void SubscribeToEvent(TOwner* ownerInstance, void (TOwner::*callbackFunction)(TEvent&)) {
+            if (!subscribers[typeid(TEvent)].get()) {
+                subscribers[typeid(TEvent)] = std::make_unique<std::list<std::unique_ptr<LegacyEventCallbackBase>>>();
+            }
+            subscribers[typeid(TEvent)]->push_back(std::make_unique<LegacyEventCallback<TOwner, TEvent>>(ownerInstance, callbackFunction));
+        }
+
+        template <typename TEvent, typename ...TArgs>
+        void EmitEvent(TArgs&& ...args) {
+            auto handlers = subscribers[typeid(TEvent)].get();
+            if (handlers) {
+                for (auto it = handlers->begin(); it != handlers->end(); it++) {
+                    TEvent event(std::forward<TArgs>(args)...);
+                    it->get()->Execute(event);
+                }
+            }
+        }
+};
+
+// === Benchmark === //
+
+class HitEvent: public Event {
+    public:
+        int a;
+        int b;
+        HitEvent(int a, int b): a(a), b(b) {}
+
+        bool operator <(const HitEvent& other) const { return a < other.a; }
+};
+
+// Other event types, so the legacy map has more than one node to search
+class OtherEventA: public Event {};
+class OtherEventB: public Event {};
+class OtherEventC: public Event {};
+
+class Subscriber {
+    public:
+        long total = 0;
+
+        void OnHit(HitEvent& event) {
+            total += event.a ^ event.b;
+        }
+
+        void OnHits(EventSpan<HitEvent> events) {
+            for (const auto& event: events) {
+                total += event.a ^ event.b;
+            }
+        }
+
+        void OnOther(OtherEventA&) {}
+        void OnOtherB(OtherEventB&) {}
+        void OnOtherC(OtherEventC&) {}
+};
+
+const int NUM_EMITS = 1000000;
+
+// Events queued between two flushes, about what a busy frame produces
+const int EVENTS_PER_FLUSH = 256;
+
+template <typename TBus>
+double MeasureEmitsPerSecond(int numSubscribers, long& total) {
+    TBus bus;
+    std::vector<Subscriber> subscribers(numSubscribers);
+    for (auto& subscriber: subscribers) {
+        bus.template SubscribeToEvent<HitEvent>(&subscriber, &Subscriber::OnHit);
+        bus.template SubscribeToEvent<OtherEventA>(&subscriber, &Subscriber::OnOther);
+        bus.template SubscribeToEvent<OtherEventB>(&subscriber, &Subscriber::OnOtherB);
+        bus.template SubscribeToEvent<OtherEventC>(&subscriber, &Subscriber::OnOtherC);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NUM_EMITS; i++) {
+        bus.template EmitEvent<HitEvent>(i, i + 1);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    total = 0;
+    for (const auto& subscriber: subscribers) {
+        total += subscriber.total;
+    }
+    return NUM_EMITS / elapsed.count();
+}
+
+double MeasureQueuedEventsPerSecond(int numSubscribers, long& total) {
+    EventBus bus;
+    std::vector<Subscriber> subscribers(numSubscribers);
+    for (auto& subscriber: subscribers) {
+        bus.SubscribeToEvent<HitEvent>(&subscriber, &Subscriber::OnHits);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NUM_EMITS; i++) {
+        bus.QueueEvent<HitEvent>(i, i + 1);
+        if ((i + 1) % EVENTS_PER_FLUSH == 0) {
+            bus.FlushEvents();
+        }
+    }
+    bus.FlushEvents();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    total = 0;
+    for (const auto& subscriber: subscribers) {
+        total += subscriber.total;
+    }
+    return NUM_EMITS / elapsed.count();
+}
+
+int main() {
+    std::printf("%12s %16s %16s %9s\n", "subscribers", "legacy emits/s", "emits/s", "speedup");
+    for (int numSubscribers: {1, 4, 16}) {
+        long legacyTotal;
+        long total;
+        const double legacyRate = MeasureEmitsPerSecond<LegacyEventBus>(numSubscribers, legacyTotal);
+        const double rate = MeasureEmitsPerSecond<EventBus>(numSubscribers, total);
+
+        if (legacyTotal != total) {
+            std::printf("Handlers saw different events with %d subscribers\n", numSubscribers);
+            return 1;
+        }
+        std::printf("%12d %16.3g %16.3g %8.1fx\n", numSubscribers, legacyRate, rate, rate / legacyRate);
+    }
+
+    std::printf("\n%12s %16s %16s %9s\n", "subscribers", "emits/s", "queued/s", "speedup");
+    for (int numSubscribers: {1, 4, 16}) {
+        long emittedTotal;
+        long queuedTotal;
+        const double emitRate = MeasureEmitsPerSecond<EventBus>(numSubscribers, emittedTotal);
+        const double queuedRate = MeasureQueuedEventsPerSecond(numSubscribers, queuedTotal);
+
+        if (emittedTotal != queuedTotal) {
+            std::printf("Batch handlers saw different events with %d subscribers\n", numSubscribers);
+            return 1;
+        }
+        std::printf("%12d %16.3g %16.3g %8.1fx\n", numSubscribers, emitRate, queuedRate, queuedRate / emitRate);
+    }
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+// Multi-threaded event queuing benchmark: 8 producer threads queue events into the EventBus at
+// the same time, then one flush merges and delivers them. The baseline is one shared buffer behind
+// a mutex, sorted the same way at the flush. Both must deliver the events in the same order, run
+// after run. Build and run with `make bench`.
+
+#include "../src/EventBus/EventBus.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class HitEvent: public Event {
+    public:
+        int entityId;
+        int damage;
+        HitEvent(int entityId, int damage): entityId(entityId), damage(damage) {}
+
+        bool operator <(const HitEvent& other) const { return entityId < other.entityId; }
+};
+
+// Folds the delivery order into one number, so two runs can be compared
+class OrderChecksum {
+    public:
+        unsigned long checksum = 0;
+        size_t count = 0;
+
+        void OnHits(EventSpan<HitEvent> events) {
+            for (const auto& event: events) {
+                checksum = checksum * 31 + static_cast<unsigned long>(event.entityId) * 7 + event.damage;
+            }
+            count += events.size();
+        }
+};
+
+// === Baseline: one buffer for all threads === //
+
+class MutexEventQueue {
+    private:
+        std::mutex mutex;
+        std::vector<HitEvent> events;
+
+    public:
+        void QueueEvent(int entityId, int damage) {
+            std::lock_guard<std::mutex> lock(mutex);
+            events.emplace_back(entityId, damage);
+        }
+
+        void FlushEvents(OrderChecksum& handler) {
+            std::stable_sort(events.begin(), events.end());
+            handler.OnHits(EventSpan<HitEvent>(events.data(), events.size()));
+            events.clear();
+        }
+};
+
+const int NUM_PRODUCERS = 8;
+const int EVENTS_PER_PRODUCER = 200000;
+const int NUM_ROUNDS = 5;
+
+struct Result {
+    double queuedPerSecond;
+    double flushMilliseconds;
+    unsigned long checksum;
+    size_t count;
+};
+
+// Starts the producers together and returns once they all finished queuing
+template <typename TQueue>
+double MeasureProducerSeconds(TQueue queue) {
+    std::atomic<bool> isStarted(false);
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < NUM_PRODUCERS; producer++) {
+        producers.emplace_back([&isStarted, queue, producer]() {
+            while (!isStarted) {
+                std::this_thread::yield();
+            }
+            // Interleaved entity ids, so the merge has to sort across producers
+            for (int i = 0; i < EVENTS_PER_PRODUCER; i++) {
+                queue(i * NUM_PRODUCERS + producer, i % 100);
+            }
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    isStarted = true;
+    for (auto& producer: producers) {
+        producer.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+Result MeasureEventBus() {
+    EventBus bus;
+    OrderChecksum handler;
+    bus.SubscribeToEvent<HitEvent>(&handler, &OrderChecksum::OnHits);
+
+    double producerSeconds = 0;
+    double flushSeconds = 0;
+    for (int round = 0; round < NUM_ROUNDS; round++) {
+        producerSeconds += MeasureProducerSeconds([&bus](int entityId, int damage) {
+            bus.QueueEvent<HitEvent>(entityId, damage);
+        });
+
+        const auto start = std::chrono::steady_clock::now();
+        bus.FlushEvents();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        flushSeconds += elapsed.count();
+    }
+
+    const double numEvents = static_cast<double>(NUM_PRODUCERS) * EVENTS_PER_PRODUCER * NUM_ROUNDS;
+    return {numEvents / producerSeconds, flushSeconds * 1000 / NUM_ROUNDS, handler.checksum, handler.count};
+}
+
+Result MeasureMutexQueue() {
+    MutexEventQueue queue;
+    OrderChecksum handler;
+
+    double producerSeconds = 0;
+    double flushSeconds = 0;
+    for (int round = 0; round < NUM_ROUNDS; round++) {
+        producerSeconds += MeasureProducerSeconds([&queue](int entityId, int damage) {
+            queue.QueueEvent(entityId, damage);
+        });
+
+        const auto start = std::chrono::steady_clock::now();
+        queue.FlushEvents(handler);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        flushSeconds += elapsed.count();
+    }
+
+    const double numEvents = static_cast<double>(NUM_PRODUCERS) * EVENTS_PER_PRODUCER * NUM_ROUNDS;
+    return {numEvents / producerSeconds, flushSeconds * 1000 / NUM_ROUNDS, handler.checksum, handler.count};
+}
+
+int main() {
+    std::printf("%d producer threads, %d events each, %u hardware threads\n", NUM_PRODUCERS, EVENTS_PER_PRODUCER, std::thread::hardware_concurrency());
+
+    const Result mutexResult = MeasureMutexQueue();
+    const Result busResult = MeasureEventBus();
+    const Result busRerun = MeasureEventBus();
+
+    const size_t expectedCount = static_cast<size_t>(NUM_PRODUCERS) * EVENTS_PER_PRODUCER * NUM_ROUNDS;
+    if (busResult.count != expectedCount || mutexResult.count != expectedCount) {
+        std::printf("Events were lost: %zu delivered by the bus, %zu by the mutex queue, %zu queued\n", busResult.count, mutexResult.count, expectedCount);
+        return 1;
+    }
+    if (busResult.checksum != busRerun.checksum || busResult.checksum != mutexResult.checksum) {
+        std::printf("Delivery order differs between runs\n");
+        return 1;
+    }
+
+    std::printf("%18s %16s %12s\n", "", "queued/s", "flush ms");
+    std::printf("%18s %16.3g %12.2f\n", "shared + mutex", mutexResult.queuedPerSecond, mutexResult.flushMilliseconds);
+    std::printf("%18s %16.3g %12.2f\n", "per-thread buffers", busResult.queuedPerSecond, busResult.flushMilliseconds);
+    std::printf("Queuing speedup: %.1fx, same delivery order in every run\n", busResult.queuedPerSecond / mutexResult.queuedPerSecond);
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+// ParallelForEach benchmark: a movement-style update over 500k entities with a transform and a
+// rigid body, as a serial View::Each loop vs. View::ParallelForEach and System::ParallelForEach
+// on thread pools of 1 to 16 threads. Speedups are against the serial loop and can't exceed the
+// number of hardware threads, which is printed first. Build and run with `make bench`.
+
+#include "../src/ECS/ECS.h"
+#include "../src/Scheduler/ThreadPool.h"
+#include "../src/Components/TransformComponent.h"
+#include "../src/Components/RigidBodyComponent.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+class MovingSystem: public System {
+    public:
+        MovingSystem() {
+            RequireComponent<TransformComponent>();
+            RequireComponent<RigidBodyComponent>(ACCESS_READ);
+        }
+};
+
+const int NUM_ENTITIES = 500000;
+const double DELTA_TIME = 1.0 / 60.0;
+const float MAP_SIZE = 4096;
+
+// What MovementSystem does to an entity, minus the tag lookups and kills
+void Move(TransformComponent& transform, const RigidBodyComponent& rigidBody) {
+    transform.position += rigidBody.velocity * static_cast<float>(DELTA_TIME);
+    if (transform.position.x < 0 || transform.position.x > MAP_SIZE) {
+        transform.position.x = transform.position.x < 0 ? transform.position.x + MAP_SIZE : transform.position.x - MAP_SIZE;
+    }
+    if (transform.position.y < 0 || transform.position.y > MAP_SIZE) {
+        transform.position.y = transform.position.y < 0 ? transform.position.y + MAP_SIZE : transform.position.y - MAP_SIZE;
+    }
+}
+
+// Entities updated per second, over enough updates to run for about 200ms
+template <typename TFunc>
+double MeasureEntitiesPerSecond(TFunc&& func) {
+    using Clock = std::chrono::steady_clock;
+    int numUpdates = 0;
+    const auto start = Clock::now();
+    std::chrono::duration<double> elapsed(0);
+    while (elapsed.count() < 0.2) {
+        func();
+        numUpdates++;
+        elapsed = Clock::now() - start;
+    }
+    return static_cast<double>(NUM_ENTITIES) * numUpdates / elapsed.count();
+}
+
+int main() {
+    // The pools and the registry log every entity; keep that out of the output
+    std::streambuf* output = std::cout.rdbuf(nullptr);
+
+    Registry registry;
+    registry.AddSystem<MovingSystem>();
+    const auto entities = registry.CreateEntities(NUM_ENTITIES);
+    registry.AddComponents<TransformComponent>(entities, glm::vec2(MAP_SIZE / 2, MAP_SIZE / 2), glm::vec2(1, 1), 0.0);
+    registry.AddComponents<RigidBodyComponent>(entities, glm::vec2(0, 0));
+    registry.Update();
+    for (size_t i = 0; i < entities.size(); i++) {
+        registry.GetComponent<RigidBodyComponent>(entities[i]).velocity = glm::vec2(static_cast<float>(i % 200) - 100, static_cast<float>(i % 120) - 60);
+    }
+    Logger::messages.clear();
+
+    const auto view = registry.GetView<TransformComponent, RigidBodyComponent>();
+    const auto& system = registry.GetSystem<MovingSystem>();
+
+    const double serialEntitiesPerSecond = MeasureEntitiesPerSecond([&]() {
+        view.Each([](Entity, TransformComponent& transform, const RigidBodyComponent& rigidBody) {
+            Move(transform, rigidBody);
+        });
+    });
+
+    std::cout.rdbuf(output);
+    std::printf("%d entities, %u hardware threads, serial Each: %.3g entities/s\n", NUM_ENTITIES, std::thread::hardware_concurrency(), serialEntitiesPerSecond);
+    std::printf("%8s %16s %9s %18s %9s\n", "threads", "view entities/s", "speedup", "system entities/s", "speedup");
+
+    for (int numThreads: {1, 2, 4, 8, 16}) {
+        std::cout.rdbuf(nullptr);
+        double viewEntitiesPerSecond = 0;
+        double systemEntitiesPerSecond = 0;
+        {
+            ThreadPool threadPool(numThreads - 1);
+            viewEntitiesPerSecond = MeasureEntitiesPerSecond([&]() {
+                view.ParallelForEach(threadPool, [](Entity, TransformComponent& transform, const RigidBodyComponent& rigidBody) {
+                    Move(transform, rigidBody);
+                });
+            });
+            systemEntitiesPerSecond = MeasureEntitiesPerSecond([&]() {
+                system.ParallelForEach(threadPool, [](Entity entity) {
+                    Move(entity.GetComponent<TransformComponent>(), entity.GetComponent<RigidBodyComponent>());
+                });
+            });
+        }
+        std::cout.rdbuf(output);
+        std::printf("%8d %16.3g %8.2fx %18.3g %8.2fx\n", numThreads, viewEntitiesPerSecond, viewEntitiesPerSecond / serialEntitiesPerSecond, systemEntitiesPerSecond, systemEntitiesPerSecond / serialEntitiesPerSecond);
+    }
+
+    std::cout.rdbuf(nullptr);
+    return 0;
+}
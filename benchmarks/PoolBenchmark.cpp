@@ -0,0 +1,146 @@
+// Component pool benchmark: Set/Get/Remove throughput of the sparse-set Pool vs. the previous
+// pool, which mapped entity ids to slots and back with two std::unordered_map. Entity ids are
+// visited in random order, as systems and collisions do. Build and run with `make bench`.
+
+#include "../src/ECS/ECS.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// === Previous pool, kept here as the baseline === //
+
+template <typename T>
+class LegacyPool {
+    private:
+        std::vector<T> data;
+        int size;
+
+        std::unordered_map<int, int> entityIdToIndex;
+        std::unordered_map<int, int> indexToEntityId;
+
+    public:
+        LegacyPool(int capacity = 100) {
+            size = 0;
+            data.resize(capacity);
+        }
+
+        void Set(int entityId, T object) {
+            if (entityIdToIndex.find(entityId) != entityIdToIndex.end()) {
+                int index = entityIdToIndex[entityId];
+                data[index] = object;
+            } else {
+                int index = size;
+                entityIdToIndex.emplace(entityId, index);
+                indexToEntityId.emplace(index, entityId);
+                if (index >= static_cast<int>(data.capacity())) {
+                    data.resize(size * 2);
+                }
+                data[index] = object;
+                size++;
+            }
+        }
+
+        void Remove(int entityId) {
+            int indexOfRemoved = entityIdToIndex[entityId];
+            int indexOfLast = size - 1;
+            data[indexOfRemoved] = data[indexOfLast];
+
+            int entityIdOfLastElement = indexToEntityId[indexOfLast];
+            entityIdToIndex[entityIdOfLastElement] = indexOfRemoved;
+            indexToEntityId[indexOfRemoved] = entityIdOfLastElement;
+
+            entityIdToIndex.erase(entityId);
+            indexToEntityId.erase(indexOfLast);
+
+            size--;
+        }
+
+        T& Get(int entityId) {
+            int index = entityIdToIndex[entityId];
+            return data[index];
+        }
+};
+
+// About the size of a TransformComponent
+struct TestComponent {
+    float x = 0;
+    float y = 0;
+    float scaleX = 1;
+    float scaleY = 1;
+    double rotation = 0;
+};
+
+struct Throughput {
+    double setsPerSecond;
+    double getsPerSecond;
+    double removesPerSecond;
+    double checksum;
+};
+
+template <typename TPool>
+Throughput Measure(const std::vector<int>& entityIds) {
+    using Clock = std::chrono::steady_clock;
+    const double count = static_cast<double>(entityIds.size());
+    TPool pool;
+    Throughput throughput;
+
+    auto start = Clock::now();
+    for (int entityId: entityIds) {
+        TestComponent component;
+        component.x = static_cast<float>(entityId);
+        pool.Set(entityId, component);
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    throughput.setsPerSecond = count / elapsed.count();
+
+    // A few passes, so the small sizes run long enough to time
+    const int numGetPasses = std::max(1, 1000000 / static_cast<int>(entityIds.size()));
+    double checksum = 0;
+    start = Clock::now();
+    for (int pass = 0; pass < numGetPasses; pass++) {
+        for (int entityId: entityIds) {
+            checksum += pool.Get(entityId).x;
+        }
+    }
+    elapsed = Clock::now() - start;
+    throughput.getsPerSecond = count * numGetPasses / elapsed.count();
+    throughput.checksum = checksum;
+
+    start = Clock::now();
+    for (int entityId: entityIds) {
+        pool.Remove(entityId);
+    }
+    elapsed = Clock::now() - start;
+    throughput.removesPerSecond = count / elapsed.count();
+
+    return throughput;
+}
+
+int main() {
+    std::mt19937 random(42);
+
+    std::printf("%10s %8s %14s %14s %9s\n", "entities", "op", "legacy ops/s", "ops/s", "speedup");
+    for (int count: {10000, 100000, 1000000}) {
+        std::vector<int> entityIds(count);
+        std::iota(entityIds.begin(), entityIds.end(), 0);
+        std::shuffle(entityIds.begin(), entityIds.end(), random);
+
+        const Throughput legacy = Measure<LegacyPool<TestComponent>>(entityIds);
+        const Throughput sparseSet = Measure<Pool<TestComponent>>(entityIds);
+
+        if (legacy.checksum != sparseSet.checksum) {
+            std::printf("The pools returned different components with %d entities\n", count);
+            return 1;
+        }
+
+        std::printf("%10d %8s %14.3g %14.3g %8.1fx\n", count, "set", legacy.setsPerSecond, sparseSet.setsPerSecond, sparseSet.setsPerSecond / legacy.setsPerSecond);
+        std::printf("%10d %8s %14.3g %14.3g %8.1fx\n", count, "get", legacy.getsPerSecond, sparseSet.getsPerSecond, sparseSet.getsPerSecond / legacy.getsPerSecond);
+        std::printf("%10d %8s %14.3g %14.3g %8.1fx\n", count, "remove", legacy.removesPerSecond, sparseSet.removesPerSecond, sparseSet.removesPerSecond / legacy.removesPerSecond);
+    }
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Signature matching benchmark: the (entity & system) == system test that decides which systems
+// an entity belongs to, with the previous std::bitset<32> signature vs. Signature::Contains at
+// this build's ECS_MAX_COMPONENTS, and a std::bitset of the same width for reference. Entities
+// use the game's 12 component types. `make bench` runs it at the default width and at 256 bits.
+
+#include "../src/ECS/ECS.h"
+#include <bitset>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+const int NUM_COMPONENT_TYPES = 12;
+const int NUM_ENTITIES = 100000;
+const int NUM_SYSTEMS = 16;
+
+struct Result {
+    double nanosecondsPerTest;
+    long long numMatches;
+};
+
+// Tests every entity against every system, over enough passes to run for about 200ms
+template <typename TSignature, typename TContains>
+Result Measure(const std::vector<TSignature>& entities, const std::vector<TSignature>& systems, TContains&& contains) {
+    using Clock = std::chrono::steady_clock;
+    long long numTests = 0;
+    long long numMatches = 0;
+    const auto start = Clock::now();
+    std::chrono::duration<double, std::nano> elapsed(0);
+    while (elapsed.count() < 200e6) {
+        for (const auto& entity: entities) {
+            for (const auto& system: systems) {
+                numMatches += contains(entity, system);
+            }
+        }
+        numTests += static_cast<long long>(entities.size() * systems.size());
+        elapsed = Clock::now() - start;
+    }
+    return {elapsed.count() / numTests, numMatches * static_cast<long long>(entities.size() * systems.size()) / numTests};
+}
+
+// Component ids of random entities and systems: entities have about half the types, systems one to three
+std::vector<std::vector<int>> RandomComponentIds(std::mt19937& random, int count, int minComponents, int maxComponents) {
+    std::vector<std::vector<int>> componentIds(count);
+    for (auto& ids: componentIds) {
+        const int numComponents = minComponents + static_cast<int>(random() % (maxComponents - minComponents + 1));
+        for (int i = 0; i < numComponents; i++) {
+            ids.push_back(static_cast<int>(random() % NUM_COMPONENT_TYPES));
+        }
+    }
+    return componentIds;
+}
+
+template <typename TSignature>
+std::vector<TSignature> ToSignatures(const std::vector<std::vector<int>>& componentIds) {
+    std::vector<TSignature> signatures(componentIds.size());
+    for (size_t i = 0; i < componentIds.size(); i++) {
+        for (int componentId: componentIds[i]) {
+            signatures[i].set(componentId);
+        }
+    }
+    return signatures;
+}
+
+int main() {
+    std::mt19937 random(42);
+    const auto entityComponentIds = RandomComponentIds(random, NUM_ENTITIES, 3, 9);
+    const auto systemComponentIds = RandomComponentIds(random, NUM_SYSTEMS, 1, 3);
+
+    using LegacySignature = std::bitset<32>;
+    using WideBitset = std::bitset<MAX_COMPONENTS>;
+    const Result legacy = Measure(ToSignatures<LegacySignature>(entityComponentIds), ToSignatures<LegacySignature>(systemComponentIds),
+        [](const LegacySignature& entity, const LegacySignature& system) { return (entity & system) == system; });
+    const Result bitset = Measure(ToSignatures<WideBitset>(entityComponentIds), ToSignatures<WideBitset>(systemComponentIds),
+        [](const WideBitset& entity, const WideBitset& system) { return (entity & system) == system; });
+    const Result signature = Measure(ToSignatures<Signature>(entityComponentIds), ToSignatures<Signature>(systemComponentIds),
+        [](const Signature& entity, const Signature& system) { return entity.Contains(system); });
+
+    if (legacy.numMatches != bitset.numMatches || legacy.numMatches != signature.numMatches) {
+        std::printf("The signatures disagree: %lld, %lld and %lld matches\n", legacy.numMatches, bitset.numMatches, signature.numMatches);
+        return 1;
+    }
+
+    std::printf("%d entities x %d systems, %lld matches per pass, MAX_COMPONENTS = %u\n", NUM_ENTITIES, NUM_SYSTEMS, signature.numMatches, MAX_COMPONENTS);
+    std::printf("%28s %14s %9s\n", "", "ns per test", "speedup");
+    std::printf("%28s %14.3f %9s\n", "std::bitset<32> (previous)", legacy.nanosecondsPerTest, "");
+    std::printf("%28s %14.3f %8.2fx\n", "std::bitset<MAX_COMPONENTS>", bitset.nanosecondsPerTest, legacy.nanosecondsPerTest / bitset.nanosecondsPerTest);
+    std::printf("%28s %14.3f %8.2fx\n", "Signature::Contains", signature.nanosecondsPerTest, legacy.nanosecondsPerTest / signature.nanosecondsPerTest);
+    return 0;
+}
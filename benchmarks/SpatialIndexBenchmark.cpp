@@ -0,0 +1,134 @@
+// Spatial index benchmark: script-style queries (nearest enemy, line of sight, area scan)
+// answered by looping over every collider vs. by the spatial index. Build and run with `make bench`.
+
+#include "../src/Physics/AABB.h"
+#include "../src/Physics/CollisionFilter.h"
+#include "../src/Physics/SpatialIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+const float MAP_SIZE = 64 * 64;
+const float TILE_SIZE = 64;
+const int NUM_QUERIES = 1000;
+
+// Keeps the compiler from dropping loops whose result is otherwise unused
+volatile long sink;
+
+struct Query {
+    float x;
+    float y;
+    float targetX;
+    float targetY;
+};
+
+static float GetDistanceSquared(const AABB& box, float x, float y) {
+    const float dx = std::max(std::max(box.minX - x, x - box.maxX), 0.0f);
+    const float dy = std::max(std::max(box.minY - y, y - box.maxY), 0.0f);
+    return dx * dx + dy * dy;
+}
+
+// What a script has to do today: look at every entity
+long RunLinear(const std::vector<AABB>& boxes, const std::vector<uint32_t>& categories, const std::vector<Query>& queries) {
+    long checksum = 0;
+    for (const auto& query: queries) {
+        int nearest = -1;
+        float nearestDistanceSquared = 500 * 500;
+        int firstHit = -1;
+        float firstFraction = 2;
+        const AABB origin(query.x, query.y, query.x, query.y);
+
+        for (size_t i = 0; i < boxes.size(); i++) {
+            if (!(categories[i] & COLLISION_LAYER_ENEMY)) {
+                continue;
+            }
+            const float distanceSquared = GetDistanceSquared(boxes[i], query.x, query.y);
+            if (distanceSquared < nearestDistanceSquared) {
+                nearest = static_cast<int>(i);
+                nearestDistanceSquared = distanceSquared;
+            }
+            float fraction;
+            if (origin.Sweep(query.targetX - query.x, query.targetY - query.y, boxes[i], fraction) && fraction < firstFraction) {
+                firstHit = static_cast<int>(i);
+                firstFraction = fraction;
+            }
+            checksum += GetDistanceSquared(boxes[i], query.x, query.y) < 200 * 200;
+        }
+        checksum += nearest + firstHit;
+    }
+    return checksum;
+}
+
+long RunIndexed(SpatialIndex& spatialIndex, const std::vector<Query>& queries, std::vector<int>& items) {
+    long checksum = 0;
+    for (const auto& query: queries) {
+        const int nearest = spatialIndex.FindNearest(query.x, query.y, 500, COLLISION_LAYER_ENEMY, -1);
+        SpatialIndex::RaycastHit hit;
+        const int firstHit = spatialIndex.Raycast(query.x, query.y, query.targetX, query.targetY, COLLISION_LAYER_ENEMY, -1, hit) ? hit.item : -1;
+        items.clear();
+        spatialIndex.QueryRadius(query.x, query.y, 200, COLLISION_LAYER_ENEMY, items);
+        checksum += static_cast<long>(items.size()) + nearest + firstHit;
+    }
+    return checksum;
+}
+
+// Average milliseconds per call over about 200ms
+template <typename TFunc>
+double TimeMilliseconds(TFunc&& func) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    std::chrono::duration<double, std::milli> elapsed(0);
+    int calls = 0;
+    while (elapsed.count() < 200) {
+        func();
+        calls++;
+        elapsed = Clock::now() - start;
+    }
+    return elapsed.count() / calls;
+}
+
+int main() {
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> position(0, MAP_SIZE);
+    std::uniform_real_distribution<float> offset(-400, 400);
+    std::uniform_int_distribution<int> layer(0, 4);
+
+    std::printf("%d scripts each asking for the nearest enemy, a line of sight and the enemies in range\n", NUM_QUERIES);
+    std::printf("%9s %12s %12s %10s %9s\n", "entities", "linear ms", "indexed ms", "build ms", "speedup");
+
+    for (int count: {1000, 4000, 16000}) {
+        std::vector<AABB> boxes;
+        std::vector<uint32_t> categories;
+        for (int i = 0; i < count; i++) {
+            const float x = position(random);
+            const float y = position(random);
+            boxes.emplace_back(x, y, x + 32, y + 32);
+            categories.push_back(1u << layer(random));
+        }
+
+        std::vector<Query> queries;
+        for (int i = 0; i < NUM_QUERIES; i++) {
+            const float x = position(random);
+            const float y = position(random);
+            queries.push_back({x, y, x + offset(random), y + offset(random)});
+        }
+
+        SpatialIndex spatialIndex;
+        spatialIndex.SetCellSize(TILE_SIZE);
+        std::vector<int> items;
+
+        const double buildMs = TimeMilliseconds([&]() { spatialIndex.Build(boxes, categories); });
+        if (RunLinear(boxes, categories, queries) != RunIndexed(spatialIndex, queries, items)) {
+            std::printf("Spatial index results differ from the linear loop at %d entities\n", count);
+            return 1;
+        }
+
+        const double linearMs = TimeMilliseconds([&]() { sink = RunLinear(boxes, categories, queries); });
+        const double indexedMs = TimeMilliseconds([&]() { sink = RunIndexed(spatialIndex, queries, items); });
+        std::printf("%9d %12.3f %12.3f %10.3f %8.1fx\n", count, linearMs, indexedMs, buildMs, linearMs / indexedMs);
+    }
+
+    return 0;
+}
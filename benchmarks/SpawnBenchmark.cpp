@@ -0,0 +1,87 @@
+// Bulk spawn benchmark: load time of N entities with a transform and a rigid body, registered with
+// a system by Registry::Update(), one entity at a time (CreateEntity + AddComponent) vs. with
+// CreateEntities + AddComponents. Log output is thrown away while timing, so the per-entity
+// numbers only include building the log lines, not printing them. Build and run with `make bench`.
+
+#include "../src/ECS/ECS.h"
+#include "../src/Components/TransformComponent.h"
+#include "../src/Components/RigidBodyComponent.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+class MovingSystem: public System {
+    public:
+        MovingSystem() {
+            RequireComponent<TransformComponent>();
+            RequireComponent<RigidBodyComponent>();
+        }
+};
+
+// Logger keeps every message; drop them now and then so a million spawns don't hold gigabytes
+const int LOG_MESSAGES_KEPT = 10000;
+
+template <typename TFunc>
+double TimeMilliseconds(TFunc&& func) {
+    std::streambuf* output = std::cout.rdbuf(nullptr);
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout.rdbuf(output);
+    std::cout.clear();
+    Logger::messages.clear();
+    return elapsed.count();
+}
+
+double MeasureOneByOne(int count, int& numInSystem) {
+    Registry registry;
+    registry.AddSystem<MovingSystem>();
+
+    const double milliseconds = TimeMilliseconds([&]() {
+        for (int i = 0; i < count; i++) {
+            Entity entity = registry.CreateEntity();
+            entity.AddComponent<TransformComponent>(glm::vec2(i % 40 * 32, i / 40 * 32), glm::vec2(1, 1), 0.0);
+            entity.AddComponent<RigidBodyComponent>(glm::vec2(0, 0));
+            if (Logger::messages.size() > LOG_MESSAGES_KEPT) {
+                Logger::messages.clear();
+            }
+        }
+        registry.Update();
+    });
+
+    numInSystem = static_cast<int>(registry.GetSystem<MovingSystem>().GetSystemEntities().size());
+    return milliseconds;
+}
+
+double MeasureBulk(int count, int& numInSystem) {
+    Registry registry;
+    registry.AddSystem<MovingSystem>();
+
+    const double milliseconds = TimeMilliseconds([&]() {
+        const auto entities = registry.CreateEntities(count);
+        registry.AddComponents<TransformComponent>(entities, glm::vec2(0, 0), glm::vec2(1, 1), 0.0);
+        registry.AddComponents<RigidBodyComponent>(entities, glm::vec2(0, 0));
+        registry.Update();
+    });
+
+    numInSystem = static_cast<int>(registry.GetSystem<MovingSystem>().GetSystemEntities().size());
+    return milliseconds;
+}
+
+int main() {
+    std::printf("%10s %16s %10s %9s\n", "entities", "one by one ms", "bulk ms", "speedup");
+    for (int count: {1200, 100000, 1000000}) {
+        int numOneByOne = 0;
+        int numBulk = 0;
+        const double oneByOneMilliseconds = MeasureOneByOne(count, numOneByOne);
+        const double bulkMilliseconds = MeasureBulk(count, numBulk);
+
+        if (numOneByOne != count || numBulk != count) {
+            std::printf("Spawned %d and %d entities into the system instead of %d\n", numOneByOne, numBulk, count);
+            return 1;
+        }
+        std::printf("%10d %16.2f %10.2f %8.1fx\n", count, oneByOneMilliseconds, bulkMilliseconds, oneByOneMilliseconds / bulkMilliseconds);
+    }
+    return 0;
+}
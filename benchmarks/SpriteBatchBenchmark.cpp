@@ -0,0 +1,132 @@
+// Sprite rendering benchmark: draw calls and frame times of the batched and the per-sprite path
+// with SDL's software renderer, drawing into a surface so no window or GPU is needed. The scene is
+// about a desert map screen: 1200 tiles of one tileset, plus units of a few textures, some rotated
+// or flipped. Also counts the pixels that differ between the two paths, as a check on the vertex
+// math. Build and run with `make bench` (needs SDL 2.0.18 or newer for batching).
+
+#include "../src/Renderer/SpriteBatch.h"
+#include <SDL2/SDL.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+const int SCREEN_WIDTH = 1280;
+const int SCREEN_HEIGHT = 960;
+const int TILE_SIZE = 32;
+const int NUM_UNITS = 200;
+const int NUM_FRAMES = 200;
+
+// A texture of colored squares, so a wrong source rectangle or flip shows up in the pixel check
+SDL_Texture* CreateTexture(SDL_Renderer* renderer, int width, int height, int seed) {
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!surface) {
+        return nullptr;
+    }
+    std::mt19937 random(seed);
+    for (int y = 0; y < height; y += 8) {
+        for (int x = 0; x < width; x += 8) {
+            SDL_Rect square = {x, y, 8, 8};
+            SDL_FillRect(surface, &square, SDL_MapRGB(surface->format, random() % 256, random() % 256, random() % 256));
+        }
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    return texture;
+}
+
+struct FrameResult {
+    double milliseconds;
+    int numDrawCalls;
+    std::vector<Uint32> pixels;
+};
+
+FrameResult MeasureFrames(SDL_Renderer* renderer, SDL_Surface* screen, SpriteBatch& spriteBatch, const std::vector<SpriteDraw>& sprites) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        SDL_SetRenderDrawColor(renderer, 21, 21, 21, 255);
+        SDL_RenderClear(renderer);
+
+        spriteBatch.Begin();
+        for (const auto& sprite: sprites) {
+            spriteBatch.Add(sprite);
+        }
+        spriteBatch.End(renderer);
+
+        SDL_RenderPresent(renderer);
+    }
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    FrameResult result;
+    result.milliseconds = elapsed.count() / NUM_FRAMES;
+    result.numDrawCalls = spriteBatch.GetNumDrawCalls();
+    result.pixels.resize(SCREEN_WIDTH * SCREEN_HEIGHT);
+    for (int y = 0; y < SCREEN_HEIGHT; y++) {
+        std::memcpy(&result.pixels[y * SCREEN_WIDTH], static_cast<const Uint8*>(screen->pixels) + y * screen->pitch, SCREEN_WIDTH * sizeof(Uint32));
+    }
+    return result;
+}
+
+int main() {
+    SDL_Surface* screen = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = screen ? SDL_CreateSoftwareRenderer(screen) : nullptr;
+    if (!renderer) {
+        std::printf("Could not create a software renderer: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Texture* tileset = CreateTexture(renderer, 10 * TILE_SIZE, 3 * TILE_SIZE, 1);
+    SDL_Texture* unitTextures[] = {
+        CreateTexture(renderer, 32, 32, 2),
+        CreateTexture(renderer, 32, 32, 3),
+        CreateTexture(renderer, 64, 32, 4)
+    };
+
+    std::vector<SpriteDraw> sprites;
+    std::mt19937 random(42);
+    for (int row = 0; row < SCREEN_HEIGHT / TILE_SIZE; row++) {
+        for (int column = 0; column < SCREEN_WIDTH / TILE_SIZE; column++) {
+            const SDL_Rect srcRect = {static_cast<int>(random() % 10) * TILE_SIZE, static_cast<int>(random() % 3) * TILE_SIZE, TILE_SIZE, TILE_SIZE};
+            const SDL_Rect dstRect = {column * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE};
+            sprites.push_back({tileset, srcRect, dstRect, 0.0, SDL_FLIP_NONE, 0});
+        }
+    }
+    const SDL_RendererFlip flips[] = {SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL, SDL_FLIP_VERTICAL};
+    for (int i = 0; i < NUM_UNITS; i++) {
+        const SDL_Rect dstRect = {static_cast<int>(random() % (SCREEN_WIDTH - 64)), static_cast<int>(random() % (SCREEN_HEIGHT - 64)), 64, 64};
+        const double rotation = i % 4 == 0 ? static_cast<double>(random() % 360) : 0.0;
+        sprites.push_back({unitTextures[i % 3], {0, 0, 32, 32}, dstRect, rotation, flips[i % 3], 1 + i % 4});
+    }
+
+    SpriteBatch spriteBatch;
+    spriteBatch.SetBatched(false);
+    const FrameResult perSprite = MeasureFrames(renderer, screen, spriteBatch, sprites);
+
+    spriteBatch.SetBatched(true);
+    if (!spriteBatch.IsBatched()) {
+        std::printf("SDL %d.%d.%d has no SDL_RenderGeometry, only the per-sprite path can be measured\n", SDL_MAJOR_VERSION, SDL_MINOR_VERSION, SDL_PATCHLEVEL);
+        std::printf("%d sprites: %d draw calls, %.2f ms per frame\n", static_cast<int>(sprites.size()), perSprite.numDrawCalls, perSprite.milliseconds);
+        return 0;
+    }
+    const FrameResult batched = MeasureFrames(renderer, screen, spriteBatch, sprites);
+
+    int numDifferentPixels = 0;
+    for (size_t i = 0; i < perSprite.pixels.size(); i++) {
+        numDifferentPixels += perSprite.pixels[i] != batched.pixels[i];
+    }
+
+    std::printf("%d sprites, software renderer, %dx%d\n", static_cast<int>(sprites.size()), SCREEN_WIDTH, SCREEN_HEIGHT);
+    std::printf("%12s %12s %14s\n", "", "draw calls", "ms per frame");
+    std::printf("%12s %12d %14.2f\n", "per sprite", perSprite.numDrawCalls, perSprite.milliseconds);
+    std::printf("%12s %12d %14.2f\n", "batched", batched.numDrawCalls, batched.milliseconds);
+    std::printf("Speedup: %.1fx, %.2f%% of the pixels differ between the two paths\n", perSprite.milliseconds / batched.milliseconds, 100.0 * numDifferentPixels / perSprite.pixels.size());
+
+    SDL_DestroyTexture(tileset);
+    for (SDL_Texture* texture: unitTextures) {
+        SDL_DestroyTexture(texture);
+    }
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(screen);
+    return 0;
+}
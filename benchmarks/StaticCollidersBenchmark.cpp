@@ -0,0 +1,123 @@
+// Static collider benchmark: one spatial hash over every collider vs. a spatial hash over the
+// moving colliders plus queries into a prebuilt grid of the static ones. Obstacles are tile sized
+// and never move; enemies drift a little every frame. Build and run with `make bench`.
+
+#include "../src/Physics/AABB.h"
+#include "../src/Physics/CollisionFilter.h"
+#include "../src/Physics/SpatialHash.h"
+#include "../src/Physics/StaticGrid.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+const float MAP_SIZE = 64 * 64;
+const float TILE_SIZE = 64;
+const int NUM_DYNAMIC = 1000;
+
+struct Scene {
+    std::vector<AABB> staticBoxes;
+    std::vector<CollisionFilter> staticFilters;
+    std::vector<AABB> dynamicBoxes;
+    std::vector<CollisionFilter> dynamicFilters;
+    std::vector<float> velocities;
+
+    // Every collider in one list, statics first, as a broad phase without the split sees them
+    std::vector<AABB> allBoxes;
+    std::vector<CollisionFilter> allFilters;
+
+    Scene(int numStatic, std::mt19937& random) {
+        std::uniform_real_distribution<float> position(0, MAP_SIZE);
+        std::uniform_real_distribution<float> size(16, 64);
+        std::uniform_real_distribution<float> velocity(-2, 2);
+
+        // Obstacles block enemies but not each other
+        for (int i = 0; i < numStatic; i++) {
+            const float x = position(random);
+            const float y = position(random);
+            staticBoxes.emplace_back(x, y, x + size(random), y + size(random));
+            staticFilters.emplace_back(COLLISION_LAYER_OBSTACLE, COLLISION_LAYER_ENEMY);
+        }
+        for (int i = 0; i < NUM_DYNAMIC; i++) {
+            const float x = position(random);
+            const float y = position(random);
+            dynamicBoxes.emplace_back(x, y, x + 32, y + 32);
+            dynamicFilters.emplace_back(COLLISION_LAYER_ENEMY, COLLISION_LAYER_ENEMY | COLLISION_LAYER_OBSTACLE);
+            velocities.push_back(velocity(random));
+        }
+    }
+
+    void Step() {
+        for (size_t i = 0; i < dynamicBoxes.size(); i++) {
+            dynamicBoxes[i].minX += velocities[i];
+            dynamicBoxes[i].maxX += velocities[i];
+        }
+        allBoxes = staticBoxes;
+        allBoxes.insert(allBoxes.end(), dynamicBoxes.begin(), dynamicBoxes.end());
+        allFilters = staticFilters;
+        allFilters.insert(allFilters.end(), dynamicFilters.begin(), dynamicFilters.end());
+    }
+};
+
+int CountAll(const Scene& scene, SpatialHash& spatialHash) {
+    return static_cast<int>(spatialHash.FindOverlappingPairs(scene.allBoxes, scene.allFilters).size());
+}
+
+int CountSplit(const Scene& scene, SpatialHash& spatialHash, StaticGrid& staticGrid, std::vector<int>& hits) {
+    int pairs = static_cast<int>(spatialHash.FindOverlappingPairs(scene.dynamicBoxes, scene.dynamicFilters).size());
+    for (size_t i = 0; i < scene.dynamicBoxes.size(); i++) {
+        hits.clear();
+        staticGrid.Query(scene.dynamicBoxes[i], scene.dynamicFilters[i], hits);
+        pairs += static_cast<int>(hits.size());
+    }
+    return pairs;
+}
+
+// Average milliseconds per frame over about 200ms. The scene steps outside the timer.
+template <typename TFunc>
+double TimeMilliseconds(Scene& scene, TFunc&& func) {
+    using Clock = std::chrono::steady_clock;
+    std::chrono::duration<double, std::milli> elapsed(0);
+    int frames = 0;
+    while (elapsed.count() < 200) {
+        scene.Step();
+        const auto start = Clock::now();
+        func();
+        elapsed += Clock::now() - start;
+        frames++;
+    }
+    return elapsed.count() / frames;
+}
+
+int main() {
+    std::mt19937 random(1234);
+
+    std::printf("%d dynamic colliders\n", NUM_DYNAMIC);
+    std::printf("%8s %8s %12s %12s %10s %9s\n", "static", "pairs", "all in hash", "static grid", "build ms", "speedup");
+
+    for (int numStatic: {1000, 4000, 16000}) {
+        Scene scene(numStatic, random);
+        SpatialHash spatialHash(TILE_SIZE);
+        SpatialHash dynamicHash(TILE_SIZE);
+        StaticGrid staticGrid;
+        staticGrid.SetCellSize(TILE_SIZE);
+        std::vector<int> hits;
+
+        const auto buildStart = std::chrono::steady_clock::now();
+        staticGrid.Build(scene.staticBoxes, scene.staticFilters);
+        const std::chrono::duration<double, std::milli> buildMs = std::chrono::steady_clock::now() - buildStart;
+
+        scene.Step();
+        const int pairs = CountAll(scene, spatialHash);
+        if (pairs != CountSplit(scene, dynamicHash, staticGrid, hits)) {
+            std::printf("Static grid results differ from the single spatial hash at %d static colliders\n", numStatic);
+            return 1;
+        }
+
+        const double allMs = TimeMilliseconds(scene, [&]() { CountAll(scene, spatialHash); });
+        const double splitMs = TimeMilliseconds(scene, [&]() { CountSplit(scene, dynamicHash, staticGrid, hits); });
+        std::printf("%8d %8d %12.3f %12.3f %10.3f %8.1fx\n", numStatic, pairs, allMs, splitMs, buildMs.count(), allMs / splitMs);
+    }
+
+    return 0;
+}
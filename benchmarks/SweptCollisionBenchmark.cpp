@@ -0,0 +1,122 @@
+// Swept collision benchmark: thousands of 4x4 bullets fired through 32x32 enemies.
+// Compares hits found by testing end-of-frame boxes only with hits found by sweeping the bullets,
+// at a normal frame time and at a frame hitch, and times a whole frame of swept collision.
+// Build and run with `make bench`.
+
+#include "../src/Physics/AABB.h"
+#include "../src/Physics/CollisionFilter.h"
+#include "../src/Physics/SpatialHash.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+const float MAP_SIZE = 64 * 32;
+const float TILE_SIZE = 64;
+const int NUM_ENEMIES = 400;
+const float BULLET_SPEED = 300;
+
+struct Scene {
+    // Enemies first, then bullets
+    std::vector<AABB> boxes;
+    std::vector<AABB> sweptBoxes;
+    std::vector<float> displacementsX;
+    std::vector<float> displacementsY;
+    std::vector<CollisionFilter> filters;
+
+    Scene(int numBullets, float deltaTime, std::mt19937& random) {
+        std::uniform_real_distribution<float> position(0, MAP_SIZE);
+        std::uniform_int_distribution<int> direction(0, 3);
+        const float dx[] = {1, -1, 0, 0};
+        const float dy[] = {0, 0, 1, -1};
+
+        for (int i = 0; i < NUM_ENEMIES; i++) {
+            float x = position(random);
+            float y = position(random);
+            Add(AABB(x, y, x + 32, y + 32), 0, 0, CollisionFilter(COLLISION_LAYER_ENEMY, COLLISION_LAYER_PROJECTILE));
+        }
+
+        // Bullets have already moved this frame, like after the movement system ran
+        for (int i = 0; i < numBullets; i++) {
+            const int d = direction(random);
+            const float x = position(random);
+            const float y = position(random);
+            Add(AABB(x, y, x + 4, y + 4), dx[d] * BULLET_SPEED * deltaTime, dy[d] * BULLET_SPEED * deltaTime, CollisionFilter(COLLISION_LAYER_PROJECTILE, COLLISION_LAYER_ENEMY));
+        }
+    }
+
+    void Add(const AABB& box, float displacementX, float displacementY, CollisionFilter filter) {
+        boxes.push_back(box);
+        displacementsX.push_back(displacementX);
+        displacementsY.push_back(displacementY);
+        sweptBoxes.emplace_back(
+            std::min(box.minX, box.minX - displacementX),
+            std::min(box.minY, box.minY - displacementY),
+            std::max(box.maxX, box.maxX - displacementX),
+            std::max(box.maxY, box.maxY - displacementY)
+        );
+        filters.push_back(filter);
+    }
+
+    // Same test as CollisionSystem: sweep one box from its start position relative to the other
+    bool IsTouching(int a, int b) const {
+        const AABB aStart(boxes[a].minX - displacementsX[a], boxes[a].minY - displacementsY[a], boxes[a].maxX - displacementsX[a], boxes[a].maxY - displacementsY[a]);
+        const AABB bStart(boxes[b].minX - displacementsX[b], boxes[b].minY - displacementsY[b], boxes[b].maxX - displacementsX[b], boxes[b].maxY - displacementsY[b]);
+        float timeOfImpact;
+        return aStart.Sweep(displacementsX[a] - displacementsX[b], displacementsY[a] - displacementsY[b], bStart, timeOfImpact);
+    }
+};
+
+int CountDiscreteHits(const Scene& scene, SpatialHash& spatialHash) {
+    return static_cast<int>(spatialHash.FindOverlappingPairs(scene.boxes, scene.filters).size());
+}
+
+int CountSweptHits(const Scene& scene, SpatialHash& spatialHash) {
+    int hits = 0;
+    for (const auto& pair: spatialHash.FindOverlappingPairs(scene.sweptBoxes, scene.filters)) {
+        hits += scene.IsTouching(pair.first, pair.second);
+    }
+    return hits;
+}
+
+// Average milliseconds per call over about 200ms
+template <typename TFunc>
+double TimeMilliseconds(TFunc&& func) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    std::chrono::duration<double, std::milli> elapsed(0);
+    int calls = 0;
+    while (elapsed.count() < 200) {
+        func();
+        calls++;
+        elapsed = Clock::now() - start;
+    }
+    return elapsed.count() / calls;
+}
+
+int main() {
+    std::mt19937 random(1234);
+
+    std::printf("%d enemies of 32x32, 4x4 bullets at %.0f px/s\n", NUM_ENEMIES, BULLET_SPEED);
+    std::printf("%8s %8s %14s %11s %15s %12s\n", "bullets", "fps", "discrete hits", "swept hits", "discrete ms", "swept ms");
+
+    for (int numBullets: {1000, 4000, 16000}) {
+        for (int fps: {60, 10}) {
+            Scene scene(numBullets, 1.0f / fps, random);
+            SpatialHash spatialHash(TILE_SIZE);
+
+            const int discreteHits = CountDiscreteHits(scene, spatialHash);
+            const int sweptHits = CountSweptHits(scene, spatialHash);
+            if (sweptHits < discreteHits) {
+                std::printf("Swept collision missed end-of-frame overlaps\n");
+                return 1;
+            }
+
+            const double discreteMs = TimeMilliseconds([&]() { CountDiscreteHits(scene, spatialHash); });
+            const double sweptMs = TimeMilliseconds([&]() { CountSweptHits(scene, spatialHash); });
+            std::printf("%8d %8d %14d %11d %15.3f %12.3f\n", numBullets, fps, discreteHits, sweptHits, discreteMs, sweptMs);
+        }
+    }
+
+    return 0;
+}
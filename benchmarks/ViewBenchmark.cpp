@@ -0,0 +1,91 @@
+// View benchmark: a movement-style update over entities with a transform and a rigid body,
+// walking the system's entities and calling GetComponent twice per entity vs. iterating
+// registry.GetView<TransformComponent, RigidBodyComponent>(). A third of the entities only have
+// a transform, so the view has to skip them. Build and run with `make bench`.
+
+#include "../src/ECS/ECS.h"
+#include "../src/Components/TransformComponent.h"
+#include "../src/Components/RigidBodyComponent.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+class MovingSystem: public System {
+    public:
+        MovingSystem() {
+            RequireComponent<TransformComponent>();
+            RequireComponent<RigidBodyComponent>();
+        }
+};
+
+const double DELTA_TIME = 1.0 / 60.0;
+
+// Average milliseconds per update over enough updates to run for about 200ms
+template <typename TFunc>
+double TimeMilliseconds(TFunc&& func) {
+    using Clock = std::chrono::steady_clock;
+    int numUpdates = 0;
+    const auto start = Clock::now();
+    std::chrono::duration<double, std::milli> elapsed(0);
+    while (elapsed.count() < 200) {
+        func();
+        numUpdates++;
+        elapsed = Clock::now() - start;
+    }
+    return elapsed.count() / numUpdates;
+}
+
+double Checksum(Registry& registry) {
+    double checksum = 0;
+    registry.GetView<TransformComponent>().Each([&](Entity, const TransformComponent& transform) {
+        checksum += transform.position.x + transform.position.y;
+    });
+    return checksum;
+}
+
+void Measure(StorageMode storageMode, int numMoving) {
+    Registry registry(storageMode);
+    registry.AddSystem<MovingSystem>();
+
+    const auto moving = registry.CreateEntities(numMoving);
+    registry.AddComponents<TransformComponent>(moving, glm::vec2(10, 20), glm::vec2(1, 1), 0.0);
+    registry.AddComponents<RigidBodyComponent>(moving, glm::vec2(30, -40));
+    const auto still = registry.CreateEntities(numMoving / 2);
+    registry.AddComponents<TransformComponent>(still, glm::vec2(50, 60), glm::vec2(1, 1), 0.0);
+    registry.Update();
+
+    const auto& system = registry.GetSystem<MovingSystem>();
+    const double perEntityMilliseconds = TimeMilliseconds([&]() {
+        for (auto entity: system.GetSystemEntities()) {
+            auto& transform = entity.GetComponent<TransformComponent>();
+            const auto& rigidBody = entity.GetComponent<RigidBodyComponent>();
+            transform.position += rigidBody.velocity * static_cast<float>(DELTA_TIME);
+        }
+    });
+    const double perEntityChecksum = Checksum(registry);
+
+    auto view = registry.GetView<TransformComponent, RigidBodyComponent>();
+    const double viewMilliseconds = TimeMilliseconds([&]() {
+        view.Each([](Entity, TransformComponent& transform, const RigidBodyComponent& rigidBody) {
+            transform.position += rigidBody.velocity * static_cast<float>(DELTA_TIME);
+        });
+    });
+
+    // Both loops moved every entity, so the sums must keep changing; a zero checksum means a loop did nothing
+    if (perEntityChecksum == 0 || Checksum(registry) == perEntityChecksum) {
+        std::printf("An update did not move the entities\n");
+        return;
+    }
+
+    std::printf("%10s %10d %16.3f %12.3f %8.1fx\n", storageMode == STORAGE_POOLS ? "pools" : "archetypes", numMoving, perEntityMilliseconds, viewMilliseconds, perEntityMilliseconds / viewMilliseconds);
+}
+
+int main() {
+    std::printf("%10s %10s %16s %12s %9s\n", "storage", "entities", "GetComponent ms", "view ms", "speedup");
+    for (StorageMode storageMode: {STORAGE_POOLS, STORAGE_ARCHETYPES}) {
+        for (int numMoving: {10000, 100000, 1000000}) {
+            Measure(storageMode, numMoving);
+        }
+    }
+    return 0;
+}
@@ -1,17 +1,26 @@
 #ifndef BOXCOLLIDERCOMPONENT_H
 #define BOXCOLLIDERCOMPONENT_H
 
+#include "../Physics/CollisionFilter.h"
 #include <glm/glm.hpp>
 
 struct BoxColliderComponent {
     int width;
     int height;
     glm::vec2 offset;
+    CollisionFilter filter;
+    // Fast colliders are swept along their velocity, so they can't pass through thin colliders between frames
+    bool isFast;
+    // Static colliders never move. Colliders of entities without a RigidBodyComponent are static too.
+    bool isStatic;
 
-    BoxColliderComponent(int width = 0, int height = 0, glm::vec2 offset = glm::vec2(0)) {
+    BoxColliderComponent(int width = 0, int height = 0, glm::vec2 offset = glm::vec2(0), CollisionFilter filter = CollisionFilter(), bool isFast = false, bool isStatic = false) {
         this->width = width;
         this->height = height;
         this->offset = offset;
+        this->filter = filter;
+        this->isFast = isFast;
+        this->isStatic = isStatic;
     }
 };
 
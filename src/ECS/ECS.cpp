@@ -1,12 +1,33 @@
 #include "ECS.h"
 #include "../Logger/Logger.h"
+#include <cstdlib>
 
-int IComponent::nextId = 0;
+std::atomic<int> IComponent::nextId(0);
+
+std::atomic<uint64_t> Registry::nextInstanceId(0);
+
+int IComponent::NewId() {
+    const int id = nextId++;
+    // Signatures have no room for the id, setting its bit would write past their end
+    if (id >= static_cast<int>(MAX_COMPONENTS)) {
+        Logger::Err("Too many component types, rebuild with a larger ECS_MAX_COMPONENTS.");
+        std::abort();
+    }
+    return id;
+}
 
 int Entity::GetId() const {
     return id;
 }
 
+int Entity::GetGeneration() const {
+    return generation;
+}
+
+bool Entity::IsAlive() const {
+    return registry->IsAlive(*this);
+}
+
 void Entity::Kill() {
     registry->KillEntity(*this);
 }
@@ -28,16 +49,38 @@ bool Entity::BelongsToGroup(const std::string& group) const {
 }
 
 void System::AddEntityToSystem(Entity entity) {
+    const auto entityId = entity.GetId();
+    if (entityId >= static_cast<int>(entityIndexPerId.size())) {
+        entityIndexPerId.resize(entityId + 1, -1);
+    }
+    if (entityIndexPerId[entityId] != -1) {
+        return;
+    }
+    entityIndexPerId[entityId] = entities.size();
     entities.push_back(entity);
 }
 
 void System::RemoveEntityFromSystem(Entity entity) {
-    entities.erase(std::remove_if(entities.begin(), entities.end(),[&entity](Entity other) {
-        return entity == other;
-    }), entities.end());
+    if (!HasEntity(entity)) {
+        return;
+    }
+
+    // Move the last entity into the freed slot to keep the vector packed
+    const int indexOfRemoved = entityIndexPerId[entity.GetId()];
+    const Entity lastEntity = entities.back();
+    entities[indexOfRemoved] = lastEntity;
+    entityIndexPerId[lastEntity.GetId()] = indexOfRemoved;
+
+    entities.pop_back();
+    entityIndexPerId[entity.GetId()] = -1;
 }
 
-std::vector<Entity> System::GetSystemEntities() const {
+bool System::HasEntity(Entity entity) const {
+    const auto entityId = entity.GetId();
+    return entityId < static_cast<int>(entityIndexPerId.size()) && entityIndexPerId[entityId] != -1;
+}
+
+const std::vector<Entity>& System::GetSystemEntities() const {
     return entities;
 }
 
@@ -45,7 +88,202 @@ const Signature& System::GetComponentSignature() const {
     return componentSignature;
 };
 
-Entity Registry::CreateEntity() {
+void System::RunExclusively() {
+    isExclusive = true;
+}
+
+const Signature& System::GetReadAccess() const {
+    return readAccess;
+}
+
+const Signature& System::GetWriteAccess() const {
+    return writeAccess;
+}
+
+bool System::IsExclusive() const {
+    return isExclusive;
+}
+
+bool System::ConflictsWith(const System& other) const {
+    if (isExclusive || other.isExclusive) {
+        return true;
+    }
+    return (writeAccess & other.readAccess).any() || (other.writeAccess & readAccess).any();
+}
+
+Archetype::Archetype(const Signature& signature, const std::vector<std::unique_ptr<IComponentColumn>>& columnPrototypes):
+    signature(signature), columnPrototypes(columnPrototypes) {
+    columnPerComponent.fill(-1);
+    for (unsigned int componentId = 0; componentId < MAX_COMPONENTS; componentId++) {
+        if (signature.test(componentId)) {
+            columnPerComponent[componentId] = componentIds.size();
+            componentIds.push_back(componentId);
+        }
+    }
+}
+
+const Signature& Archetype::GetSignature() const {
+    return signature;
+}
+
+const std::vector<int>& Archetype::GetComponentIds() const {
+    return componentIds;
+}
+
+int Archetype::GetNumChunks() const {
+    return chunks.size();
+}
+
+ArchetypeChunk& Archetype::GetChunk(int chunk) {
+    return chunks[chunk];
+}
+
+IComponentColumn& Archetype::GetColumn(int chunk, int componentId) {
+    return *chunks[chunk].columns[columnPerComponent[componentId]];
+}
+
+void Archetype::AppendEntity(int entityId, int& chunk, int& row) {
+    if (chunks.empty() || chunks.back().entityIds.size() == CHUNK_CAPACITY) {
+        // Chunks never grow past their capacity, so component addresses inside a chunk stay put
+        ArchetypeChunk newChunk;
+        newChunk.entityIds.reserve(CHUNK_CAPACITY);
+        for (auto componentId: componentIds) {
+            newChunk.columns.push_back(columnPrototypes[componentId]->CreateEmpty(CHUNK_CAPACITY));
+        }
+        chunks.push_back(std::move(newChunk));
+    }
+
+    chunk = chunks.size() - 1;
+    row = chunks.back().entityIds.size();
+    chunks.back().entityIds.push_back(entityId);
+}
+
+int Archetype::RemoveEntity(int chunk, int row) {
+    auto& lastChunk = chunks.back();
+    const int lastChunkIndex = chunks.size() - 1;
+    const int lastRow = lastChunk.entityIds.size() - 1;
+    int movedEntityId = -1;
+
+    if (chunk != lastChunkIndex || row != lastRow) {
+        auto& targetChunk = chunks[chunk];
+        for (size_t column = 0; column < componentIds.size(); column++) {
+            targetChunk.columns[column]->MoveFrom(row, *lastChunk.columns[column], lastRow);
+        }
+        movedEntityId = lastChunk.entityIds[lastRow];
+        targetChunk.entityIds[row] = movedEntityId;
+    }
+
+    for (auto& column: lastChunk.columns) {
+        column->PopBack();
+    }
+    lastChunk.entityIds.pop_back();
+
+    if (lastChunk.entityIds.empty()) {
+        chunks.pop_back();
+    }
+
+    return movedEntityId;
+}
+
+void* CommandBuffer::Arena::Allocate(size_t size, size_t alignment) {
+    while (currentBlock < blocks.size()) {
+        const size_t alignedOffset = (offset + alignment - 1) / alignment * alignment;
+        if (alignedOffset + size <= blocks[currentBlock].second) {
+            offset = alignedOffset + size;
+            return blocks[currentBlock].first.get() + alignedOffset;
+        }
+        currentBlock++;
+        offset = 0;
+    }
+
+    // Out of room: add a block, large enough for oversized payloads too
+    const size_t blockSize = std::max(BLOCK_SIZE, size);
+    blocks.emplace_back(std::make_unique<unsigned char[]>(blockSize), blockSize);
+    currentBlock = blocks.size() - 1;
+    offset = size;
+    return blocks[currentBlock].first.get();
+}
+
+void CommandBuffer::Arena::Reset() {
+    currentBlock = 0;
+    offset = 0;
+}
+
+CommandBuffer::~CommandBuffer() {
+    Clear();
+}
+
+Entity CommandBuffer::CreateEntity() {
+    numEntitiesToCreate++;
+    return Entity(-numEntitiesToCreate);
+}
+
+void CommandBuffer::KillEntity(Entity entity) {
+    commands.push_back({BATCH_KILLS, entity, nullptr, &ApplyKill, nullptr});
+}
+
+void CommandBuffer::Tag(Entity entity, const std::string& tag) {
+    commands.push_back({BATCH_TAGS, entity, NewPayload<std::string>(tag), &ApplyTag, nullptr});
+}
+
+void CommandBuffer::Group(Entity entity, const std::string& group) {
+    commands.push_back({BATCH_TAGS, entity, NewPayload<std::string>(group), &ApplyGroup, nullptr});
+}
+
+void CommandBuffer::Defer(std::function<void(Registry&)> command) {
+    commands.push_back({BATCH_CALLBACKS, Entity(0), NewPayload<std::function<void(Registry&)>>(std::move(command)), &ApplyCallback, nullptr});
+}
+
+bool CommandBuffer::IsEmpty() const {
+    return commands.empty() && numEntitiesToCreate == 0;
+}
+
+void CommandBuffer::Clear() {
+    for (auto& command: commands) {
+        command.apply(nullptr, command.entity, command.payload);
+    }
+    commands.clear();
+    numEntitiesToCreate = 0;
+    arena.Reset();
+}
+
+void CommandBuffer::Swap(CommandBuffer& other) {
+    std::swap(commands, other.commands);
+    std::swap(arena, other.arena);
+    std::swap(numEntitiesToCreate, other.numEntitiesToCreate);
+}
+
+void CommandBuffer::ApplyTag(Registry* registry, Entity entity, void* payload) {
+    std::string* tag = static_cast<std::string*>(payload);
+    if (registry && registry->IsAlive(entity)) {
+        registry->TagEntity(entity, *tag);
+    }
+    tag->~basic_string();
+}
+
+void CommandBuffer::ApplyGroup(Registry* registry, Entity entity, void* payload) {
+    std::string* group = static_cast<std::string*>(payload);
+    if (registry && registry->IsAlive(entity)) {
+        registry->GroupEntity(entity, *group);
+    }
+    group->~basic_string();
+}
+
+void CommandBuffer::ApplyCallback(Registry* registry, Entity entity, void* payload) {
+    auto* callback = static_cast<std::function<void(Registry&)>*>(payload);
+    if (registry) {
+        (*callback)(*registry);
+    }
+    callback->~function();
+}
+
+void CommandBuffer::ApplyKill(Registry* registry, Entity entity, void* payload) {
+    if (registry && registry->IsAlive(entity)) {
+        registry->entitiesToBeKilled.insert(entity);
+    }
+}
+
+Entity Registry::AllocateEntity() {
     int entityId;
 
     if (freeIds.empty()) {
@@ -53,23 +291,170 @@ Entity Registry::CreateEntity() {
 
         if (entityId >= entityComponentSignatures.size()) {
             entityComponentSignatures.resize(entityId + 1);
+            entitySystemSignatures.resize(entityId + 1);
+            entityGenerations.resize(entityId + 1, 0);
+            if (storageMode == STORAGE_ARCHETYPES) {
+                entityLocations.resize(entityId + 1);
+            }
         }
     } else {
         entityId = freeIds.front();
         freeIds.pop_front();
     }
 
-    Entity entity(entityId);
-    entity.registry = this;
-    entitiesToBeAdded.insert(entity);
+    Entity entity = GetEntity(entityId);
+    entitiesToBeAdded.push_back(entity);
+
+    return entity;
+}
+
+Entity Registry::CreateEntity() {
+    Entity entity = AllocateEntity();
 
-    Logger::Log("Entity created: " + std::to_string(entityId));
+    Logger::Log("Entity created: " + std::to_string(entity.GetId()));
 
     return entity;
 }
 
+std::vector<Entity> Registry::CreateEntities(int count) {
+    std::vector<Entity> entities;
+    AppendNewEntities(count, entities);
+    return entities;
+}
+
+void Registry::AppendNewEntities(int count, std::vector<Entity>& entities) {
+    entities.reserve(entities.size() + count);
+
+    const auto capacity = numEntities + count;
+    entityComponentSignatures.reserve(capacity);
+    entitySystemSignatures.reserve(capacity);
+    entityGenerations.reserve(capacity);
+    if (storageMode == STORAGE_ARCHETYPES) {
+        entityLocations.reserve(capacity);
+    }
+    entitiesToBeAdded.reserve(entitiesToBeAdded.size() + count);
+
+    for (int i = 0; i < count; i++) {
+        entities.push_back(AllocateEntity());
+    }
+
+    Logger::Log(std::to_string(count) + " entities created.");
+}
+
 void Registry::KillEntity(Entity entity) {
-    entitiesToBeKilled.insert(entity);
+    // Ignore stale handles, their id may already belong to somebody else
+    if (IsAlive(entity)) {
+        GetCommandBuffer().KillEntity(entity);
+    }
+}
+
+void Registry::KillEntities(const std::vector<Entity>& entities) {
+    for (auto entity: entities) {
+        KillEntity(entity);
+    }
+}
+
+void Registry::Defer(std::function<void(Registry&)> command) {
+    GetCommandBuffer().Defer(std::move(command));
+}
+
+CommandBuffer& Registry::GetCommandBuffer() {
+    // Remember the buffer this thread used last, so only a thread's first call takes the lock.
+    // Registries are told apart by instance id, since a new one may reuse a destroyed one's address.
+    thread_local uint64_t cachedInstanceId = UINT64_MAX;
+    thread_local CommandBuffer* cachedCommandBuffer = nullptr;
+
+    if (cachedInstanceId != instanceId) {
+        std::lock_guard<std::mutex> lock(commandBuffersMutex);
+        const auto inserted = commandBufferIndexPerThread.emplace(std::this_thread::get_id(), commandBuffers.size());
+        if (inserted.second) {
+            commandBuffers.push_back(std::make_unique<CommandBuffer>());
+        }
+        cachedInstanceId = instanceId;
+        cachedCommandBuffer = commandBuffers[inserted.first->second].get();
+    }
+    return *cachedCommandBuffer;
+}
+
+void Registry::PlayBackCommands() {
+    // Played back commands may record new ones (e.g. a callback killing what it created).
+    // Those get a few more passes; anything still left waits for the next Update().
+    const int MAX_PASSES = 4;
+
+    for (int pass = 0; pass < MAX_PASSES; pass++) {
+        size_t numBuffers = 0;
+        {
+            std::lock_guard<std::mutex> lock(commandBuffersMutex);
+            for (auto& commandBuffer: commandBuffers) {
+                if (commandBuffer->IsEmpty()) {
+                    continue;
+                }
+                if (numBuffers == playbackBuffers.size()) {
+                    playbackBuffers.push_back(std::make_unique<CommandBuffer>());
+                }
+                playbackBuffers[numBuffers++]->Swap(*commandBuffer);
+            }
+        }
+
+        if (numBuffers == 0) {
+            return;
+        }
+
+        // Create every entity first and point the placeholder handles at them
+        auto& commands = playbackCommands;
+        commands.clear();
+        for (size_t i = 0; i < numBuffers; i++) {
+            auto& commandBuffer = *playbackBuffers[i];
+
+            playbackCreatedEntities.clear();
+            if (commandBuffer.numEntitiesToCreate > 0) {
+                AppendNewEntities(commandBuffer.numEntitiesToCreate, playbackCreatedEntities);
+            }
+
+            for (auto& command: commandBuffer.commands) {
+                if (command.entity.GetId() < 0) {
+                    command.entity = playbackCreatedEntities[-command.entity.GetId() - 1];
+                }
+                commands.push_back(&command);
+            }
+        }
+
+        // Group commands by batch (component type, then tags, callbacks and kills) and walk entities in id order
+        std::stable_sort(commands.begin(), commands.end(), [](const CommandBuffer::Command* a, const CommandBuffer::Command* b) {
+            return a->batch < b->batch || (a->batch == b->batch && a->entity.GetId() < b->entity.GetId());
+        });
+
+        for (size_t i = 0; i < commands.size(); i++) {
+            const auto reserve = commands[i]->reserve;
+            if (reserve && (i == 0 || commands[i - 1]->reserve != reserve)) {
+                // Grow the pool once for the whole run of additions
+                size_t end = i;
+                while (end < commands.size() && commands[end]->reserve == reserve) {
+                    end++;
+                }
+                reserve(*this, static_cast<int>(end - i));
+            }
+            commands[i]->apply(this, commands[i]->entity, commands[i]->payload);
+        }
+
+        // Every payload was consumed by its command, so only the storage is recycled
+        for (size_t i = 0; i < numBuffers; i++) {
+            playbackBuffers[i]->commands.clear();
+            playbackBuffers[i]->numEntitiesToCreate = 0;
+            playbackBuffers[i]->arena.Reset();
+        }
+    }
+}
+
+bool Registry::IsAlive(Entity entity) const {
+    const auto entityId = entity.GetId();
+    return entityId >= 0 && entityId < static_cast<int>(entityGenerations.size()) && entityGenerations[entityId] == entity.GetGeneration();
+}
+
+Entity Registry::GetEntity(int entityId) const {
+    Entity entity(entityId, entityGenerations[entityId]);
+    entity.registry = const_cast<Registry*>(this);
+    return entity;
 }
 
 void Registry::AddEntityToSystems(Entity entity) {
@@ -84,18 +469,96 @@ void Registry::AddEntityToSystems(Entity entity) {
         // Ex. (1111 & 0101) == 0101
         //     (0101) == 0101
         // So a 0101 system is interested in an entity with a 1111 signature
-        bool isInterested = (entityComponentSignature & systemComponentSignature) == systemComponentSignature;
+        bool isInterested = entityComponentSignature.Contains(systemComponentSignature);
 
         if (isInterested) {
             system.second->AddEntityToSystem(entity);
         }
     }
+
+    entitySystemSignatures[entityId] = entityComponentSignature;
+}
+
+void Registry::AddEntitiesToSystems(const std::vector<Entity>& entities) {
+    // Entities created together usually share a signature, so only re-match systems when it changes
+    std::vector<System*> interestedSystems;
+    Signature lastSignature;
+    bool hasLastSignature = false;
+
+    for (auto entity: entities) {
+        const auto entityId = entity.GetId();
+        const auto& entityComponentSignature = entityComponentSignatures[entityId];
+
+        if (!hasLastSignature || entityComponentSignature != lastSignature) {
+            interestedSystems.clear();
+            for (auto& system: systems) {
+                const auto& systemComponentSignature = system.second->GetComponentSignature();
+                if (entityComponentSignature.Contains(systemComponentSignature)) {
+                    interestedSystems.push_back(system.second.get());
+                }
+            }
+            lastSignature = entityComponentSignature;
+            hasLastSignature = true;
+        }
+
+        for (auto system: interestedSystems) {
+            system->AddEntityToSystem(entity);
+        }
+
+        entitySystemSignatures[entityId] = entityComponentSignature;
+    }
 }
 
 void Registry::RemoveEntityFromSystems(Entity entity) {
+    const auto& entitySystemSignature = entitySystemSignatures[entity.GetId()];
+
     for (auto& system: systems) {
+        const auto& systemComponentSignature = system.second->GetComponentSignature();
+
+        // Skip systems that never matched the entity
+        if (!entitySystemSignature.Contains(systemComponentSignature)) {
+            continue;
+        }
+
         system.second->RemoveEntityFromSystem(entity);
     }
+
+    entitySystemSignatures[entity.GetId()].reset();
+}
+
+void Registry::TrackSignatureChange(Entity entity) {
+    // Only the first change away from what the systems saw needs to be queued
+    const auto entityId = entity.GetId();
+    if (entityComponentSignatures[entityId] == entitySystemSignatures[entityId]) {
+        entitiesWithChangedSignature.push_back(entity);
+    }
+}
+
+void Registry::UpdateEntityInSystems(Entity entity) {
+    const auto entityId = entity.GetId();
+
+    const auto& oldSignature = entitySystemSignatures[entityId];
+    const auto& newSignature = entityComponentSignatures[entityId];
+
+    if (oldSignature == newSignature) {
+        return;
+    }
+
+    for (auto& system: systems) {
+        const auto& systemComponentSignature = system.second->GetComponentSignature();
+
+        bool wasInterested = oldSignature.Contains(systemComponentSignature);
+        bool isInterested = newSignature.Contains(systemComponentSignature);
+
+        if (isInterested && !wasInterested) {
+            system.second->AddEntityToSystem(entity);
+        }
+        if (wasInterested && !isInterested) {
+            system.second->RemoveEntityFromSystem(entity);
+        }
+    }
+
+    entitySystemSignatures[entityId] = newSignature;
 }
 
 void Registry::TagEntity(Entity entity, const std::string& tag) {
@@ -107,7 +570,8 @@ bool Registry::EntityHasTag(Entity entity, const std::string& tag) const {
 	if (tagPerEntity.find(entity.GetId()) == tagPerEntity.end()) {
 		return false;
 	}
-	return entityPerTag.find(tag)->second == entity;
+	auto taggedEntity = entityPerTag.find(tag);
+	return taggedEntity != entityPerTag.end() && taggedEntity->second == entity;
 }
 
 Entity Registry::GetEntityByTag(const std::string& tag) const {
@@ -133,8 +597,8 @@ bool Registry::EntityBelongsToGroup(Entity entity, const std::string& group) con
 	if (entitiesPerGroup.find(group) == entitiesPerGroup.end()) {
         return false;
     }
-    auto groupEntities = entitiesPerGroup.at(group);
-    return groupEntities.find(entity.GetId()) != groupEntities.end();
+    const auto& groupEntities = entitiesPerGroup.at(group);
+    return groupEntities.find(entity) != groupEntities.end();
 }
 
 std::vector<Entity> Registry::GetEntitiesByGroup(const std::string& group) const {
@@ -156,15 +620,77 @@ void Registry::RemoveEntityGroup(Entity entity) {
     }
 }
 
-void Registry::Update() {
-    for (auto entity: entitiesToBeAdded) {
-        AddEntityToSystems(entity);
+StorageMode Registry::GetStorageMode() const {
+    return storageMode;
+}
+
+const std::vector<std::unique_ptr<Archetype>>& Registry::GetArchetypes() const {
+    return archetypes;
+}
+
+Archetype* Registry::GetOrCreateArchetype(const Signature& signature) {
+    auto archetype = archetypePerSignature.find(signature);
+    if (archetype != archetypePerSignature.end()) {
+        return archetype->second;
+    }
+
+    archetypes.push_back(std::make_unique<Archetype>(signature, columnPrototypes));
+    archetypePerSignature.emplace(signature, archetypes.back().get());
+    return archetypes.back().get();
+}
+
+void Registry::MoveEntityToArchetype(int entityId, const Signature& signature) {
+    auto& location = entityLocations[entityId];
+    if (location.archetype && location.archetype->GetSignature() == signature) {
+        return;
+    }
+    EntityLocation newLocation;
+
+    if (signature.any()) {
+        // Move every component the old and new archetypes share into a fresh row
+        newLocation.archetype = GetOrCreateArchetype(signature);
+        newLocation.archetype->AppendEntity(entityId, newLocation.chunk, newLocation.row);
+
+        if (location.archetype) {
+            for (auto componentId: location.archetype->GetComponentIds()) {
+                if (signature.test(componentId)) {
+                    newLocation.archetype->GetColumn(newLocation.chunk, componentId).PushFrom(
+                        location.archetype->GetColumn(location.chunk, componentId), location.row);
+                }
+            }
+        }
     }
+
+    if (location.archetype) {
+        int movedEntityId = location.archetype->RemoveEntity(location.chunk, location.row);
+        if (movedEntityId != -1) {
+            entityLocations[movedEntityId].chunk = location.chunk;
+            entityLocations[movedEntityId].row = location.row;
+        }
+    }
+
+    location = newLocation;
+}
+
+void Registry::Update() {
+    PlayBackCommands();
+
+    AddEntitiesToSystems(entitiesToBeAdded);
     entitiesToBeAdded.clear();
 
+    // Entities added above already match their latest signature, so this only patches live entities
+    for (auto entity: entitiesWithChangedSignature) {
+        UpdateEntityInSystems(entity);
+    }
+    entitiesWithChangedSignature.clear();
+
     for (auto entity: entitiesToBeKilled) {
         RemoveEntityFromSystems(entity);
 
+        if (storageMode == STORAGE_ARCHETYPES) {
+            MoveEntityToArchetype(entity.GetId(), Signature());
+        }
+
         entityComponentSignatures[entity.GetId()].reset();
 
         for (auto pool: componentPools) {
@@ -173,6 +699,7 @@ void Registry::Update() {
             }
         }
 
+        entityGenerations[entity.GetId()]++;
         freeIds.push_back(entity.GetId());
 
         RemoveEntityTag(entity);
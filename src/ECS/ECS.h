@@ -2,28 +2,113 @@
 #define ECS_H
 
 #include "../Logger/Logger.h"
+#include "../Scheduler/ThreadPool.h"
 
-#include <bitset>
+#include <cstdint>
 #include <vector>
 #include <unordered_map>
 #include <typeindex>
 #include <set>
 #include <deque>
+#include <memory>
+#include <algorithm>
+#include <tuple>
+#include <array>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <cstddef>
+#include <new>
+#include <cstdlib>
+
+// Number of component types the engine supports. Override at build time with -DECS_MAX_COMPONENTS=128 (or 256, ...)
+#ifndef ECS_MAX_COMPONENTS
+#define ECS_MAX_COMPONENTS 64
+#endif
 
-const unsigned int MAX_COMPONENTS = 32;
+const unsigned int MAX_COMPONENTS = ECS_MAX_COMPONENTS;
 
 // === Signature === //
 // Use a bitset to keep track of components in an entity.
 // Also helps identify what entities a system uses.
+// Same interface as std::bitset, but stored as plain 64-bit words so the subset test is a short loop the compiler can vectorize.
+
+class Signature {
+    private:
+        static constexpr unsigned int NUM_WORDS = (MAX_COMPONENTS + 63) / 64;
+        std::array<uint64_t, NUM_WORDS> words{};
+
+    public:
+        void set(unsigned int bit, bool value = true) {
+            const uint64_t mask = uint64_t(1) << (bit % 64);
+            words[bit / 64] = value ? (words[bit / 64] | mask) : (words[bit / 64] & ~mask);
+        }
 
-typedef std::bitset<MAX_COMPONENTS> Signature;
+        bool test(unsigned int bit) const {
+            return (words[bit / 64] >> (bit % 64)) & 1;
+        }
+
+        void reset() {
+            words.fill(0);
+        }
+
+        bool any() const {
+            uint64_t combined = 0;
+            for (unsigned int i = 0; i < NUM_WORDS; i++) {
+                combined |= words[i];
+            }
+            return combined != 0;
+        }
+
+        // True if every bit set in other is also set here, i.e. (*this & other) == other without a temporary
+        bool Contains(const Signature& other) const {
+            uint64_t missing = 0;
+            for (unsigned int i = 0; i < NUM_WORDS; i++) {
+                missing |= other.words[i] & ~words[i];
+            }
+            return missing == 0;
+        }
+
+        size_t Hash() const {
+            size_t hash = 0;
+            for (unsigned int i = 0; i < NUM_WORDS; i++) {
+                hash = hash * 31 + std::hash<uint64_t>()(words[i]);
+            }
+            return hash;
+        }
+
+        Signature operator &(const Signature& other) const {
+            Signature result;
+            for (unsigned int i = 0; i < NUM_WORDS; i++) {
+                result.words[i] = words[i] & other.words[i];
+            }
+            return result;
+        }
+
+        bool operator ==(const Signature& other) const { return words == other.words; }
+        bool operator !=(const Signature& other) const { return words != other.words; }
+};
+
+namespace std {
+    template <>
+    struct hash<Signature> {
+        size_t operator()(const Signature& signature) const {
+            return signature.Hash();
+        }
+    };
+}
 
 // === Component === //
-// Assign a unique id to a component type
+// Assign a unique id to a component type.
+// Ids come from a single counter defined in ECS.cpp, so every translation unit sees the same id for a type.
+// Systems on worker threads may ask for a new type's id at the same time, so the counter is atomic.
 
 struct IComponent {
     protected:
-        static int nextId;
+        static std::atomic<int> nextId;
+        static int NewId();
 };
 
 template <typename TComponent>
@@ -31,23 +116,28 @@ class Component: public IComponent {
     public:
         // Return unique id
         static int GetId() {
-            static auto id = nextId++;
+            static auto id = NewId();
             return id;
         }
 };
 
 // === Entity === //
-// An object with an id
+// An object with an id, plus the generation of that id.
+// Ids are recycled, so the generation tells a live handle apart from a stale one.
+// Changes made through a stale handle are ignored; GetComponent() on one aborts, in release builds too.
 
 class Entity {
     private:
         int id;
+        int generation;
     
     public:
-        Entity(int id): id(id) {};
+        Entity(int id, int generation = 0): id(id), generation(generation) {};
         Entity(const Entity& entity) = default;
         void Kill();
         int GetId() const;
+        int GetGeneration() const;
+        bool IsAlive() const;
 
         void Tag(const std::string& tag);
         bool HasTag(const std::string& tag) const;
@@ -55,10 +145,10 @@ class Entity {
         bool BelongsToGroup(const std::string& group) const;
 
         Entity& operator =(const Entity& other) = default;
-        bool operator ==(const Entity& other) const { return id == other.id; }
-        bool operator !=(const Entity& other) const { return id != other.id; }
-        bool operator >(const Entity& other) const { return id > other.id; }
-        bool operator <(const Entity& other) const { return id < other.id; }
+        bool operator ==(const Entity& other) const { return id == other.id && generation == other.generation; }
+        bool operator !=(const Entity& other) const { return !(*this == other); }
+        bool operator >(const Entity& other) const { return other < *this; }
+        bool operator <(const Entity& other) const { return id < other.id || (id == other.id && generation < other.generation); }
 
         template <typename TComponent, typename ...TArgs> void AddComponent(TArgs&& ...args);
         template <typename TComponent> void RemoveComponent();
@@ -71,22 +161,59 @@ class Entity {
 // === System === //
 // The system processes entities with a specific signature
 
+// How a system touches a component type, used to decide which systems may run at the same time
+enum ComponentAccess {
+    ACCESS_READ,
+    ACCESS_READ_WRITE
+};
+
 class System {
     private:
         Signature componentSignature;
         std::vector<Entity> entities;
 
+        // Component types the system reads and writes, whether it requires them or not
+        Signature readAccess;
+        Signature writeAccess;
+
+        // Exclusive systems make structural changes (create entities, add components, run scripts)
+        // and never run alongside another system
+        bool isExclusive = false;
+
+        // Slot of each entity in the entities vector, or -1 if the entity isn't in the system
+        // Vector index = entity id
+        std::vector<int> entityIndexPerId;
+
     public:
         System() = default;
         ~System() = default;
 
         void AddEntityToSystem(Entity entity);
         void RemoveEntityFromSystem(Entity entity);
-        std::vector<Entity> GetSystemEntities() const;
+        bool HasEntity(Entity entity) const;
+        // Non-owning view of the system entities. Kill() and CreateEntity() only queue work that
+        // Registry::Update() applies between frames, so both are safe to call while iterating.
+        const std::vector<Entity>& GetSystemEntities() const;
         const Signature& GetComponentSignature() const;
 
-        // Define component types required by system
-        template <typename T> void RequireComponent();
+        // Invoke func(entity) for every system entity, split in chunks across the thread pool.
+        // func must only touch the entity's own components; structural changes are deferred as usual.
+        template <typename TFunc> void ParallelForEach(ThreadPool& threadPool, TFunc&& func) const;
+
+        // Define component types required by system. Access defaults to read-write unless narrowed.
+        template <typename T> void RequireComponent(ComponentAccess access = ACCESS_READ_WRITE);
+
+        // Declare access to components the system touches without requiring them (e.g. from event handlers)
+        template <typename T> void ReadsComponent();
+        template <typename T> void WritesComponent();
+        void RunExclusively();
+
+        const Signature& GetReadAccess() const;
+        const Signature& GetWriteAccess() const;
+        bool IsExclusive() const;
+
+        // Two systems conflict when one writes what the other reads or writes
+        bool ConflictsWith(const System& other) const;
 };
 
 // === Pool === //
@@ -101,80 +228,118 @@ class IPool {
 template <typename T>
 class Pool: public IPool {
     private:
+        // Sparse set: a packed array of components and, next to it, the entity id owning each slot.
+        // The sparse side maps entity id -> dense index and is split in fixed-size pages,
+        // so a few high entity ids don't force us to allocate one huge array.
+        static constexpr int PAGE_SIZE = 4096;
+        static constexpr int INVALID_INDEX = -1;
+
         std::vector<T> data;
-        int size;
+        std::vector<int> entityIds;
+        std::vector<std::vector<int>> sparsePages;
 
-        std::unordered_map<int, int> entityIdToIndex;
-        std::unordered_map<int, int> indexToEntityId;
+        int IndexOf(int entityId) const {
+            const auto page = static_cast<size_t>(entityId / PAGE_SIZE);
+            if (page >= sparsePages.size() || sparsePages[page].empty()) {
+                return INVALID_INDEX;
+            }
+            return sparsePages[page][entityId % PAGE_SIZE];
+        }
+
+        int& SparseSlot(int entityId) {
+            const auto page = static_cast<size_t>(entityId / PAGE_SIZE);
+            if (page >= sparsePages.size()) {
+                sparsePages.resize(page + 1);
+            }
+            if (sparsePages[page].empty()) {
+                sparsePages[page].assign(PAGE_SIZE, INVALID_INDEX);
+            }
+            return sparsePages[page][entityId % PAGE_SIZE];
+        }
 
     public:
         Pool(int capacity = 100) {
-            size = 0;
-            data.resize(capacity);
+            data.reserve(capacity);
+            entityIds.reserve(capacity);
         }
 
         virtual ~Pool() = default;
 
         bool IsEmpty() const {
-            return size == 0;
+            return data.empty();
         }
 
         int GetSize() const {
-            return size;
+            return static_cast<int>(data.size());
         }
 
         void Clear() {
             data.clear();
-            entityIdToIndex.clear();
-            indexToEntityId.clear();
-            size = 0;
+            entityIds.clear();
+            sparsePages.clear();
+        }
+
+        bool Has(int entityId) const {
+            return IndexOf(entityId) != INVALID_INDEX;
         }
 
         void Set(int entityId, T object) {
-            if (entityIdToIndex.find(entityId) != entityIdToIndex.end()) {
+            int& index = SparseSlot(entityId);
+            if (index != INVALID_INDEX) {
                 // If the element already exists, simply replace the component object
-                int index = entityIdToIndex[entityId];
-                data[index] = object;
+                data[index] = std::move(object);
             } else {
-                // When adding a new object, we keep track of the entity ids and their vector index
-                int index = size;
-                entityIdToIndex.emplace(entityId, index);
-                indexToEntityId.emplace(index, entityId);
-                if (index >= data.capacity()) {
-                    // If necessary, we resize by always doubling the current capacity
-                    data.resize(size * 2);
-                }
-                data[index] = object;
-                size++;
+                // When adding a new object, append it to the packed array and remember who owns it
+                index = static_cast<int>(data.size());
+                data.push_back(std::move(object));
+                entityIds.push_back(entityId);
             }
         }
 
         void Remove(int entityId) {
-            // Copy the last element to the deleted position to keep the array packed
-		    int indexOfRemoved = entityIdToIndex[entityId];
-		    int indexOfLast = size - 1;
-		    data[indexOfRemoved] = data[indexOfLast];
-
-            // Update the index-entity maps to point to the correct elements
-            int entityIdOfLastElement = indexToEntityId[indexOfLast];
-            entityIdToIndex[entityIdOfLastElement] = indexOfRemoved;
-            indexToEntityId[indexOfRemoved] = entityIdOfLastElement;
-
-            entityIdToIndex.erase(entityId);
-            indexToEntityId.erase(indexOfLast);
+            const int indexOfRemoved = IndexOf(entityId);
+            if (indexOfRemoved == INVALID_INDEX) {
+                return;
+            }
+            const int indexOfLast = GetSize() - 1;
+
+            // Move the last element to the deleted position to keep the array packed
+            if (indexOfRemoved != indexOfLast) {
+                const int entityIdOfLastElement = entityIds[indexOfLast];
+                data[indexOfRemoved] = std::move(data[indexOfLast]);
+                entityIds[indexOfRemoved] = entityIdOfLastElement;
+                SparseSlot(entityIdOfLastElement) = indexOfRemoved;
+            }
 
-            size--;
+            SparseSlot(entityId) = INVALID_INDEX;
+            data.pop_back();
+            entityIds.pop_back();
         }
 
         void RemoveEntityFromPool(int entityId) override {
-            if (entityIdToIndex.find(entityId) != entityIdToIndex.end()) {
-                Remove(entityId);
-            }
+            Remove(entityId);
         }
 
         T& Get(int entityId) {
-            int index = entityIdToIndex[entityId];
-            return static_cast<T&>(data[index]);
+            const int index = IndexOf(entityId);
+            if (index == INVALID_INDEX) {
+                Logger::Err("Pool::Get() called for entity " + std::to_string(entityId) + ", which has no such component");
+                std::abort();
+            }
+            return data[index];
+        }
+
+        int GetEntityId(unsigned int index) const {
+            return entityIds[index];
+        }
+
+        const std::vector<int>& GetEntityIds() const {
+            return entityIds;
+        }
+
+        void Reserve(int capacity) {
+            data.reserve(capacity);
+            entityIds.reserve(capacity);
         }
 
         T& operator[](unsigned int index) {
@@ -182,13 +347,222 @@ class Pool: public IPool {
         }
 };
 
+// === Archetype === //
+// Alternative storage where entities sharing a signature live together in fixed-size chunks.
+// Each chunk keeps one packed column per component type (SoA), so iterating a chunk is linear.
+
+class IComponentColumn {
+    public:
+        virtual ~IComponentColumn() = default;
+        virtual std::unique_ptr<IComponentColumn> CreateEmpty(int capacity) const = 0;
+        virtual void PushFrom(IComponentColumn& source, int sourceRow) = 0;
+        virtual void MoveFrom(int row, IComponentColumn& source, int sourceRow) = 0;
+        virtual void PopBack() = 0;
+};
+
+template <typename T>
+class ComponentColumn: public IComponentColumn {
+    private:
+        std::vector<T> data;
+
+    public:
+        ComponentColumn(int capacity = 0) {
+            data.reserve(capacity);
+        }
+
+        virtual ~ComponentColumn() = default;
+
+        std::unique_ptr<IComponentColumn> CreateEmpty(int capacity) const override {
+            return std::make_unique<ComponentColumn<T>>(capacity);
+        }
+
+        void PushFrom(IComponentColumn& source, int sourceRow) override {
+            data.push_back(std::move(static_cast<ComponentColumn<T>&>(source).data[sourceRow]));
+        }
+
+        void MoveFrom(int row, IComponentColumn& source, int sourceRow) override {
+            data[row] = std::move(static_cast<ComponentColumn<T>&>(source).data[sourceRow]);
+        }
+
+        void PopBack() override {
+            data.pop_back();
+        }
+
+        void PushBack(T object) {
+            data.push_back(std::move(object));
+        }
+
+        T* GetData() {
+            return data.data();
+        }
+};
+
+struct ArchetypeChunk {
+    std::vector<int> entityIds;
+    // Columns follow the order of the archetype component ids
+    std::vector<std::unique_ptr<IComponentColumn>> columns;
+};
+
+class Archetype {
+    private:
+        Signature signature;
+        std::vector<int> componentIds;
+        std::array<int, MAX_COMPONENTS> columnPerComponent;
+        std::vector<ArchetypeChunk> chunks;
+        const std::vector<std::unique_ptr<IComponentColumn>>& columnPrototypes;
+
+    public:
+        static constexpr int CHUNK_CAPACITY = 1024;
+
+        Archetype(const Signature& signature, const std::vector<std::unique_ptr<IComponentColumn>>& columnPrototypes);
+
+        const Signature& GetSignature() const;
+        const std::vector<int>& GetComponentIds() const;
+        int GetNumChunks() const;
+        ArchetypeChunk& GetChunk(int chunk);
+        IComponentColumn& GetColumn(int chunk, int componentId);
+
+        // Reserve a row at the end of the last chunk; the caller fills every column
+        void AppendEntity(int entityId, int& chunk, int& row);
+
+        // Fill the hole with the very last row to keep chunks packed.
+        // Returns the id of the entity that was moved into the row, or -1.
+        int RemoveEntity(int chunk, int row);
+
+        template <typename T> T* GetColumnData(int chunk, int componentId) {
+            return static_cast<ComponentColumn<T>&>(GetColumn(chunk, componentId)).GetData();
+        }
+};
+
+// === View === //
+// Iterates entities that own all the given component types, reading straight from the packed pools
+// or, in archetype mode, walking the chunks of every matching archetype
+
+template <typename ...TComponents>
+class View {
+    private:
+        class Registry* registry;
+        std::tuple<Pool<TComponents>*...> pools;
+
+    public:
+        View(class Registry* registry, Pool<TComponents>* ...pools): registry(registry), pools(pools...) {}
+
+        // Invoke func(entity, components...) for every matching entity
+        template <typename TFunc>
+        void Each(TFunc&& func) const;
+
+        // Same as Each(), but the matching entities are split in chunks and run on the thread pool.
+        // Every entity is visited exactly once, so func may write to the components it receives.
+        template <typename TFunc>
+        void ParallelForEach(ThreadPool& threadPool, TFunc&& func) const;
+
+    private:
+        // Entity ids of the smallest pool, or nullptr if some component type was never added
+        const std::vector<int>* GetLeadEntityIds() const;
+
+        template <typename TFunc>
+        void EachInPools(TFunc&& func, const std::vector<int>& leadEntityIds, size_t begin, size_t end) const;
+
+        template <typename TFunc>
+        void EachInArchetypeChunk(TFunc&& func, Archetype& archetype, int chunkIndex) const;
+
+        Signature GetSignature() const;
+};
+
+// === CommandBuffer === //
+// Records structural changes (create and kill entities, add and remove components, tags, groups)
+// so systems can make them while iterating. Registry::Update() plays the commands back in one pass:
+// creations first, then component changes batched per component type, then tags and groups,
+// then deferred callbacks, then kills. Commands on the same entity and component keep their order.
+
+class CommandBuffer {
+    private:
+        // Bump allocator for command payloads. Blocks are kept between frames and reused.
+        class Arena {
+            private:
+                static constexpr size_t BLOCK_SIZE = 64 * 1024;
+                std::vector<std::pair<std::unique_ptr<unsigned char[]>, size_t>> blocks;
+                size_t currentBlock = 0;
+                size_t offset = 0;
+
+            public:
+                void* Allocate(size_t size, size_t alignment);
+                void Reset();
+        };
+
+        // Batches played back after every component batch
+        static constexpr int BATCH_TAGS = MAX_COMPONENTS;
+        static constexpr int BATCH_CALLBACKS = MAX_COMPONENTS + 1;
+        static constexpr int BATCH_KILLS = MAX_COMPONENTS + 2;
+
+        struct Command {
+            int batch;
+            // Negative ids refer to entities created by this buffer, resolved at playback
+            Entity entity;
+            void* payload;
+            // Applies the command and destroys the payload; a null registry only destroys the payload
+            void (*apply)(Registry* registry, Entity entity, void* payload);
+            // Reserves pool room for count commands of the same kind, or nullptr
+            void (*reserve)(Registry& registry, int count);
+        };
+
+        std::vector<Command> commands;
+        Arena arena;
+        int numEntitiesToCreate = 0;
+
+        template <typename T, typename ...TArgs> T* NewPayload(TArgs&& ...args);
+
+        template <typename TComponent> static void ApplyAddComponent(Registry* registry, Entity entity, void* payload);
+        template <typename TComponent> static void ApplyRemoveComponent(Registry* registry, Entity entity, void* payload);
+        template <typename TComponent> static void ReserveComponents(Registry& registry, int count);
+        static void ApplyTag(Registry* registry, Entity entity, void* payload);
+        static void ApplyGroup(Registry* registry, Entity entity, void* payload);
+        static void ApplyCallback(Registry* registry, Entity entity, void* payload);
+        static void ApplyKill(Registry* registry, Entity entity, void* payload);
+
+        friend class Registry;
+
+    public:
+        CommandBuffer() = default;
+        ~CommandBuffer();
+        CommandBuffer(const CommandBuffer&) = delete;
+        CommandBuffer& operator =(const CommandBuffer&) = delete;
+
+        // Returns a placeholder handle, only valid as an argument to this buffer until playback
+        Entity CreateEntity();
+        void KillEntity(Entity entity);
+
+        template <typename TComponent, typename ...TArgs> void AddComponent(Entity entity, TArgs&& ...args);
+        template <typename TComponent> void RemoveComponent(Entity entity);
+
+        void Tag(Entity entity, const std::string& tag);
+        void Group(Entity entity, const std::string& group);
+
+        // Run command on the main thread once the other commands of its frame were applied
+        void Defer(std::function<void(Registry&)> command);
+
+        bool IsEmpty() const;
+
+        // Drop every recorded command without applying it
+        void Clear();
+
+        void Swap(CommandBuffer& other);
+};
+
 // === Registry === //
 // The registry manages creation and destruction of entities, components, and systems
 
+enum StorageMode {
+    STORAGE_POOLS,
+    STORAGE_ARCHETYPES
+};
+
 class Registry {
     private:
         int numEntities = 0;
 
+        StorageMode storageMode;
+
         // Vector of component pools. Each pool contains all data for a certain component type.
         // Vector index = component type id
         // Pool index = entity id
@@ -198,11 +572,46 @@ class Registry {
         // Vector index = entity id
         std::vector<Signature> entityComponentSignatures;
 
+        // Current generation of every entity id, bumped each time the id is freed
+        // Vector index = entity id
+        std::vector<int> entityGenerations;
+
+        // Signature the systems last saw for each entity, and the entities whose signature moved away from it.
+        // Registry::Update() patches system membership for those entities only.
+        // Vector index = entity id
+        std::vector<Signature> entitySystemSignatures;
+        std::vector<Entity> entitiesWithChangedSignature;
+
+        void TrackSignatureChange(Entity entity);
+
+        Entity AllocateEntity();
+
         std::unordered_map<std::type_index, std::shared_ptr<System>> systems;
 
-        std::set<Entity> entitiesToBeAdded;
+        std::vector<Entity> entitiesToBeAdded;
         std::set<Entity> entitiesToBeKilled;
 
+        // Structural changes recorded while systems run, possibly on worker threads.
+        // Each thread gets its own buffer so recording never contends; Update() plays them back on the main thread.
+        // Buffers are kept and played back in the order their threads first recorded, not in hash order.
+        std::vector<std::unique_ptr<CommandBuffer>> commandBuffers;
+        std::unordered_map<std::thread::id, size_t> commandBufferIndexPerThread;
+        std::mutex commandBuffersMutex;
+        const uint64_t instanceId;
+        static std::atomic<uint64_t> nextInstanceId;
+
+        // Recorded commands are swapped in here, so playback can record new commands safely
+        std::vector<std::unique_ptr<CommandBuffer>> playbackBuffers;
+        // Scratch space of a playback pass, cleared and reused so playback doesn't allocate every frame
+        std::vector<CommandBuffer::Command*> playbackCommands;
+        std::vector<Entity> playbackCreatedEntities;
+
+        void AppendNewEntities(int count, std::vector<Entity>& entities);
+        void PlayBackCommands();
+        template <typename TComponent> void ReserveComponents(int count);
+
+        friend class CommandBuffer;
+
         std::unordered_map<std::string, Entity> entityPerTag;
         std::unordered_map<int, std::string> tagPerEntity;
 
@@ -210,9 +619,28 @@ class Registry {
         std::unordered_map<int, std::string> groupPerEntity;
 
         std::deque<int> freeIds;
+
+        // Archetype storage, only used in STORAGE_ARCHETYPES mode
+        struct EntityLocation {
+            Archetype* archetype = nullptr;
+            int chunk = 0;
+            int row = 0;
+        };
+
+        // Vector index = component type id
+        std::vector<std::unique_ptr<IComponentColumn>> columnPrototypes;
+        std::vector<std::unique_ptr<Archetype>> archetypes;
+        std::unordered_map<Signature, Archetype*> archetypePerSignature;
+
+        // Vector index = entity id
+        std::vector<EntityLocation> entityLocations;
+
+        Archetype* GetOrCreateArchetype(const Signature& signature);
+        void MoveEntityToArchetype(int entityId, const Signature& signature);
+        template <typename TComponent> void SetArchetypeComponent(int entityId, TComponent component);
     
     public:
-        Registry() {
+        Registry(StorageMode storageMode = STORAGE_POOLS): storageMode(storageMode), instanceId(nextInstanceId++) {
             Logger::Log("Registry constructor called.");
         };
 
@@ -222,8 +650,22 @@ class Registry {
 
         void Update();
 
+        StorageMode GetStorageMode() const;
+        const std::vector<std::unique_ptr<Archetype>>& GetArchetypes() const;
+
         Entity CreateEntity();
         void KillEntity(Entity entity);
+        bool IsAlive(Entity entity) const;
+        Entity GetEntity(int entityId) const;
+
+        // Bulk versions for large spawns: no per-entity logging, storage is reserved once
+        std::vector<Entity> CreateEntities(int count);
+        void KillEntities(const std::vector<Entity>& entities);
+
+        // Command buffer of the calling thread, played back by the next Update().
+        // Use it for structural changes while iterating, including from inside ParallelForEach.
+        CommandBuffer& GetCommandBuffer();
+        void Defer(std::function<void(Registry&)> command);
 
         void TagEntity(Entity entity, const std::string& tag);
         bool EntityHasTag(Entity entity, const std::string& tag) const;
@@ -236,9 +678,13 @@ class Registry {
         void RemoveEntityGroup(Entity entity);
 
         template <typename TComponent, typename ...TArgs> void AddComponent(Entity entity, TArgs&& ...args);
+        template <typename TComponent, typename ...TArgs> void AddComponents(const std::vector<Entity>& entities, TArgs&& ...args);
         template <typename TComponent> void RemoveComponent(Entity entity);
         template <typename TComponent> bool HasComponent(Entity entity) const;
         template <typename TComponent> TComponent& GetComponent(Entity entity) const;
+        template <typename TComponent> Pool<TComponent>* GetComponentPool() const;
+
+        template <typename ...TComponents> View<TComponents...> GetView();
 
         template <typename TSystem, typename ...TArgs> void AddSystem(TArgs && ...args);
         template <typename TSystem> void RemoveSystem();
@@ -246,49 +692,153 @@ class Registry {
         template <typename TSystem> TSystem& GetSystem() const;
 
         void AddEntityToSystems(Entity entity);
+        void AddEntitiesToSystems(const std::vector<Entity>& entities);
         void RemoveEntityFromSystems(Entity entity);
+        void UpdateEntityInSystems(Entity entity);
 };
 
 // === Component template methods === //
 
 template <typename TComponent>
-void System::RequireComponent() {
+void System::RequireComponent(ComponentAccess access) {
     const auto componentId = Component<TComponent>::GetId();
     componentSignature.set(componentId);
+
+    if (access == ACCESS_READ_WRITE) {
+        WritesComponent<TComponent>();
+    } else {
+        ReadsComponent<TComponent>();
+    }
 }
 
-template <typename TComponent, typename ...TArgs> 
-void Registry::AddComponent(Entity entity, TArgs&& ...args) {
-    const auto componentId = Component<TComponent>::GetId();
-    const auto entityId = entity.GetId();
+template <typename TComponent>
+void System::ReadsComponent() {
+    readAccess.set(Component<TComponent>::GetId());
+}
 
-    if (componentId >= componentPools.size()) {
-        componentPools.resize(componentId + 1, nullptr);
+template <typename TComponent>
+void System::WritesComponent() {
+    readAccess.set(Component<TComponent>::GetId());
+    writeAccess.set(Component<TComponent>::GetId());
+}
+
+template <typename TFunc>
+void System::ParallelForEach(ThreadPool& threadPool, TFunc&& func) const {
+    const size_t count = entities.size();
+    const size_t chunkSize = threadPool.GetChunkSize(count);
+    if (count <= chunkSize) {
+        for (auto entity: entities) {
+            func(entity);
+        }
+        return;
     }
 
-    if (!componentPools[componentId]) {
-        std::shared_ptr<Pool<TComponent>> newComponentPool = std::make_shared<Pool<TComponent>>();
-        componentPools[componentId] = newComponentPool;
+    std::vector<std::function<void()>> tasks;
+    for (size_t begin = 0; begin < count; begin += chunkSize) {
+        const size_t end = std::min(begin + chunkSize, count);
+        tasks.push_back([this, &func, begin, end]() {
+            for (size_t i = begin; i < end; i++) {
+                func(entities[i]);
+            }
+        });
+    }
+    threadPool.Run(tasks);
+}
+
+template <typename TComponent, typename ...TArgs> 
+void Registry::AddComponent(Entity entity, TArgs&& ...args) {
+    // Ignore stale handles, their id may already belong to somebody else
+    if (!IsAlive(entity)) {
+        return;
     }
 
-    std::shared_ptr<Pool<TComponent>> componentPool = std::static_pointer_cast<Pool<TComponent>>(componentPools[componentId]);
+    const auto componentId = Component<TComponent>::GetId();
+    const auto entityId = entity.GetId();
 
     TComponent newComponent(std::forward<TArgs>(args)...);
 
-    componentPool->Set(entityId, newComponent);
+    if (storageMode == STORAGE_ARCHETYPES) {
+        SetArchetypeComponent<TComponent>(entityId, std::move(newComponent));
+    } else {
+        if (componentId >= componentPools.size()) {
+            componentPools.resize(componentId + 1, nullptr);
+        }
+
+        if (!componentPools[componentId]) {
+            std::shared_ptr<Pool<TComponent>> newComponentPool = std::make_shared<Pool<TComponent>>();
+            componentPools[componentId] = newComponentPool;
+        }
+
+        GetComponentPool<TComponent>()->Set(entityId, std::move(newComponent));
+    }
+    TrackSignatureChange(entity);
     entityComponentSignatures[entityId].set(componentId);
 
     Logger::Log("Component id " + std::to_string(componentId) + " was added to entity id " + std::to_string(entityId) + ".");
 }
 
+template <typename TComponent, typename ...TArgs>
+void Registry::AddComponents(const std::vector<Entity>& entities, TArgs&& ...args) {
+    const auto componentId = Component<TComponent>::GetId();
+    const TComponent newComponent(std::forward<TArgs>(args)...);
+
+    if (storageMode == STORAGE_ARCHETYPES) {
+        for (auto entity: entities) {
+            if (!IsAlive(entity)) {
+                continue;
+            }
+            SetArchetypeComponent<TComponent>(entity.GetId(), newComponent);
+            TrackSignatureChange(entity);
+            entityComponentSignatures[entity.GetId()].set(componentId);
+        }
+    } else {
+        if (static_cast<size_t>(componentId) >= componentPools.size()) {
+            componentPools.resize(componentId + 1, nullptr);
+        }
+
+        if (!componentPools[componentId]) {
+            componentPools[componentId] = std::make_shared<Pool<TComponent>>();
+        }
+
+        auto componentPool = GetComponentPool<TComponent>();
+        componentPool->Reserve(componentPool->GetSize() + entities.size());
+
+        for (auto entity: entities) {
+            if (!IsAlive(entity)) {
+                continue;
+            }
+            componentPool->Set(entity.GetId(), newComponent);
+            TrackSignatureChange(entity);
+            entityComponentSignatures[entity.GetId()].set(componentId);
+        }
+    }
+
+    Logger::Log("Component id " + std::to_string(componentId) + " was added to " + std::to_string(entities.size()) + " entities.");
+}
+
 template <typename TComponent>
 void Registry::RemoveComponent(Entity entity) {
+    if (!IsAlive(entity)) {
+        return;
+    }
+
     const auto componentId = Component<TComponent>::GetId();
     const auto entityId = entity.GetId();
 
-    std::shared_ptr<Pool<TComponent>> componentPool = std::static_pointer_cast<Pool<TComponent>>(componentPools[componentId]);
-    componentPool->Remove(entityId);
+    // Nothing to do for a component the entity doesn't own; its pool may not even exist yet
+    if (!entityComponentSignatures[entityId].test(componentId)) {
+        return;
+    }
+
+    if (storageMode == STORAGE_ARCHETYPES) {
+        Signature signature = entityComponentSignatures[entityId];
+        signature.set(componentId, false);
+        MoveEntityToArchetype(entityId, signature);
+    } else {
+        GetComponentPool<TComponent>()->Remove(entityId);
+    }
 
+    TrackSignatureChange(entity);
     entityComponentSignatures[entityId].set(componentId, false);
 
     Logger::Log("Component id " + std::to_string(componentId) + " was removed from entity id " + std::to_string(entityId) + ".");
@@ -298,15 +848,231 @@ template <typename TComponent>
 bool Registry::HasComponent(Entity entity) const {
     const auto componentId = Component<TComponent>::GetId();
     const auto entityId = entity.GetId();
-    return entityComponentSignatures[entityId].test(componentId);
+    return IsAlive(entity) && entityComponentSignatures[entityId].test(componentId);
 }
 
+// The entity must be alive and own the component; check with HasComponent() when unsure
 template <typename TComponent>
 TComponent& Registry::GetComponent(Entity entity) const {
-    const auto componentId = Component<TComponent>::GetId();
+    // Checked in release builds too: a stale handle whose id was recycled would read somebody else's component
+    if (!IsAlive(entity)) {
+        Logger::Err("GetComponent() called with a stale handle of entity " + std::to_string(entity.GetId()));
+        std::abort();
+    }
     const auto entityId = entity.GetId();
-    auto componentPool = std::static_pointer_cast<Pool<TComponent>>(componentPools[componentId]);
-    return componentPool->Get(entityId);
+
+    if (storageMode == STORAGE_ARCHETYPES) {
+        const auto& location = entityLocations[entityId];
+        return location.archetype->GetColumnData<TComponent>(location.chunk, Component<TComponent>::GetId())[location.row];
+    }
+
+    return GetComponentPool<TComponent>()->Get(entityId);
+}
+
+template <typename TComponent>
+Pool<TComponent>* Registry::GetComponentPool() const {
+    const auto componentId = Component<TComponent>::GetId();
+    if (componentId >= static_cast<int>(componentPools.size())) {
+        return nullptr;
+    }
+    return static_cast<Pool<TComponent>*>(componentPools[componentId].get());
+}
+
+template <typename ...TComponents>
+View<TComponents...> Registry::GetView() {
+    return View<TComponents...>(this, GetComponentPool<TComponents>()...);
+}
+
+template <typename TComponent>
+void Registry::SetArchetypeComponent(int entityId, TComponent component) {
+    const auto componentId = Component<TComponent>::GetId();
+
+    if (componentId >= static_cast<int>(columnPrototypes.size())) {
+        columnPrototypes.resize(componentId + 1);
+    }
+    if (!columnPrototypes[componentId]) {
+        columnPrototypes[componentId] = std::make_unique<ComponentColumn<TComponent>>();
+    }
+
+    Signature signature = entityComponentSignatures[entityId];
+
+    if (signature.test(componentId)) {
+        // If the entity already has the component, simply replace it in place
+        GetComponent<TComponent>(GetEntity(entityId)) = std::move(component);
+        return;
+    }
+
+    // Move the row to the archetype of the new signature, then fill in the missing column
+    signature.set(componentId);
+    MoveEntityToArchetype(entityId, signature);
+
+    const auto& location = entityLocations[entityId];
+    auto& column = static_cast<ComponentColumn<TComponent>&>(location.archetype->GetColumn(location.chunk, componentId));
+    column.PushBack(std::move(component));
+}
+
+// === CommandBuffer template methods === //
+
+template <typename T, typename ...TArgs>
+T* CommandBuffer::NewPayload(TArgs&& ...args) {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned command payloads are not supported");
+    return new (arena.Allocate(sizeof(T), alignof(T))) T(std::forward<TArgs>(args)...);
+}
+
+template <typename TComponent, typename ...TArgs>
+void CommandBuffer::AddComponent(Entity entity, TArgs&& ...args) {
+    TComponent* component = NewPayload<TComponent>(std::forward<TArgs>(args)...);
+    commands.push_back({static_cast<int>(Component<TComponent>::GetId()), entity, component, &ApplyAddComponent<TComponent>, &ReserveComponents<TComponent>});
+}
+
+template <typename TComponent>
+void CommandBuffer::RemoveComponent(Entity entity) {
+    commands.push_back({static_cast<int>(Component<TComponent>::GetId()), entity, nullptr, &ApplyRemoveComponent<TComponent>, nullptr});
+}
+
+template <typename TComponent>
+void CommandBuffer::ApplyAddComponent(Registry* registry, Entity entity, void* payload) {
+    TComponent* component = static_cast<TComponent*>(payload);
+    if (registry && registry->IsAlive(entity)) {
+        registry->AddComponent<TComponent>(entity, std::move(*component));
+    }
+    component->~TComponent();
+}
+
+template <typename TComponent>
+void CommandBuffer::ApplyRemoveComponent(Registry* registry, Entity entity, void* payload) {
+    if (registry && registry->HasComponent<TComponent>(entity)) {
+        registry->RemoveComponent<TComponent>(entity);
+    }
+}
+
+template <typename TComponent>
+void CommandBuffer::ReserveComponents(Registry& registry, int count) {
+    registry.ReserveComponents<TComponent>(count);
+}
+
+template <typename TComponent>
+void Registry::ReserveComponents(int count) {
+    if (storageMode == STORAGE_ARCHETYPES) {
+        return;
+    }
+
+    const auto componentId = Component<TComponent>::GetId();
+    if (static_cast<size_t>(componentId) >= componentPools.size()) {
+        componentPools.resize(componentId + 1, nullptr);
+    }
+    if (!componentPools[componentId]) {
+        componentPools[componentId] = std::make_shared<Pool<TComponent>>();
+    }
+
+    auto componentPool = GetComponentPool<TComponent>();
+    componentPool->Reserve(componentPool->GetSize() + count);
+}
+
+// === View template methods === //
+
+template <typename ...TComponents>
+template <typename TFunc>
+void View<TComponents...>::Each(TFunc&& func) const {
+    if (registry->GetStorageMode() == STORAGE_ARCHETYPES) {
+        const Signature viewSignature = GetSignature();
+        for (const auto& archetype: registry->GetArchetypes()) {
+            if (!archetype->GetSignature().Contains(viewSignature)) {
+                continue;
+            }
+            for (int chunkIndex = 0; chunkIndex < archetype->GetNumChunks(); chunkIndex++) {
+                EachInArchetypeChunk(func, *archetype, chunkIndex);
+            }
+        }
+        return;
+    }
+
+    if (const auto* leadEntityIds = GetLeadEntityIds()) {
+        EachInPools(func, *leadEntityIds, 0, leadEntityIds->size());
+    }
+}
+
+template <typename ...TComponents>
+template <typename TFunc>
+void View<TComponents...>::ParallelForEach(ThreadPool& threadPool, TFunc&& func) const {
+    std::vector<std::function<void()>> tasks;
+
+    if (registry->GetStorageMode() == STORAGE_ARCHETYPES) {
+        // Archetype chunks are already fixed-size contiguous blocks, so each one is a task
+        const Signature viewSignature = GetSignature();
+        for (const auto& archetype: registry->GetArchetypes()) {
+            if (!archetype->GetSignature().Contains(viewSignature)) {
+                continue;
+            }
+            for (int chunkIndex = 0; chunkIndex < archetype->GetNumChunks(); chunkIndex++) {
+                Archetype* chunkArchetype = archetype.get();
+                tasks.push_back([this, &func, chunkArchetype, chunkIndex]() {
+                    EachInArchetypeChunk(func, *chunkArchetype, chunkIndex);
+                });
+            }
+        }
+    } else if (const auto* leadEntityIds = GetLeadEntityIds()) {
+        const size_t count = leadEntityIds->size();
+        const size_t chunkSize = threadPool.GetChunkSize(count);
+        for (size_t begin = 0; begin < count; begin += chunkSize) {
+            const size_t end = std::min(begin + chunkSize, count);
+            tasks.push_back([this, &func, leadEntityIds, begin, end]() {
+                EachInPools(func, *leadEntityIds, begin, end);
+            });
+        }
+    }
+
+    if (tasks.size() == 1) {
+        tasks.front()();
+    } else if (!tasks.empty()) {
+        threadPool.Run(tasks);
+    }
+}
+
+template <typename ...TComponents>
+const std::vector<int>* View<TComponents...>::GetLeadEntityIds() const {
+    // If any of the component types was never added there can't be a match
+    if (((std::get<Pool<TComponents>*>(pools) == nullptr) || ...)) {
+        return nullptr;
+    }
+
+    // Walk the smallest pool and probe the others
+    const std::vector<int>* leadEntityIds = nullptr;
+    for (const auto* entityIds: {&std::get<Pool<TComponents>*>(pools)->GetEntityIds()...}) {
+        if (!leadEntityIds || entityIds->size() < leadEntityIds->size()) {
+            leadEntityIds = entityIds;
+        }
+    }
+    return leadEntityIds;
+}
+
+template <typename ...TComponents>
+template <typename TFunc>
+void View<TComponents...>::EachInPools(TFunc&& func, const std::vector<int>& leadEntityIds, size_t begin, size_t end) const {
+    for (size_t i = begin; i < end; i++) {
+        const int entityId = leadEntityIds[i];
+        if ((std::get<Pool<TComponents>*>(pools)->Has(entityId) && ...)) {
+            func(registry->GetEntity(entityId), std::get<Pool<TComponents>*>(pools)->Get(entityId)...);
+        }
+    }
+}
+
+template <typename ...TComponents>
+template <typename TFunc>
+void View<TComponents...>::EachInArchetypeChunk(TFunc&& func, Archetype& archetype, int chunkIndex) const {
+    const auto& entityIds = archetype.GetChunk(chunkIndex).entityIds;
+    std::tuple<TComponents*...> columns(archetype.template GetColumnData<TComponents>(chunkIndex, Component<TComponents>::GetId())...);
+
+    for (size_t row = 0; row < entityIds.size(); row++) {
+        func(registry->GetEntity(entityIds[row]), std::get<TComponents*>(columns)[row]...);
+    }
+}
+
+template <typename ...TComponents>
+Signature View<TComponents...>::GetSignature() const {
+    Signature viewSignature;
+    (viewSignature.set(Component<TComponents>::GetId()), ...);
+    return viewSignature;
 }
 
 // === Entity template methods === //
@@ -3,48 +3,341 @@
 
 #include "../Logger/Logger.h"
 #include "Event.h"
-#include <map>
-#include <typeindex>
-#include <list>
+#include <vector>
+#include <atomic>
+#include <cstring>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
-class IEventCallback {
-    private:
-        virtual void Call(Event& e) = 0;
+// === EventType === //
+// Unique id per event type, handed out on first use, that indexes the bus handler lists
 
-    public:
-        virtual ~IEventCallback() = default;
+struct IEventType {
+    protected:
+        inline static std::atomic<int> nextId{0};
+};
 
-        void Execute(Event& e) {
-            Call(e);
+template <typename TEvent>
+class EventType: public IEventType {
+    public:
+        static int GetId() {
+            static const int id = nextId++;
+            return id;
         }
 };
 
-template <typename TOwner, typename TEvent>
-class EventCallback: public IEventCallback {
+// === EventSpan === //
+// A contiguous run of queued events of one type, delivered to batch handlers in one call
+
+template <typename TEvent>
+class EventSpan {
     private:
+        TEvent* events;
+        size_t count;
+
+    public:
+        EventSpan(TEvent* events, size_t count): events(events), count(count) {}
+
+        TEvent* begin() const { return events; }
+        TEvent* end() const { return events + count; }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        TEvent& operator [](size_t index) const { return events[index]; }
+};
+
+// === IsEventOrdered === //
+// Whether events of the type can be sorted with operator <, which queued events need
+
+template <typename TEvent, typename = void>
+struct IsEventOrdered: std::false_type {};
+
+template <typename TEvent>
+struct IsEventOrdered<TEvent, std::void_t<decltype(std::declval<const TEvent&>() < std::declval<const TEvent&>())>>: std::true_type {};
+
+// === EventHandler === //
+// A subscriber as plain data: the owner, the member function to call on it, and a thunk that
+// knows both types. Handlers of one event type sit next to each other in a vector, so emitting
+// is a loop of indirect calls with no virtual dispatch, lookup or allocation.
+// Every handler takes a single event, which is all EmitEvent() needs. Batch handlers also have a
+// batch thunk that takes the whole run of queued events in one call; the bus steps the others through it.
+
+struct EventHandler {
+    // Large enough for a member function pointer on every ABI we build for
+    static constexpr size_t MAX_CALLBACK_SIZE = 4 * sizeof(void*);
+
+    void* owner;
+    void (*thunk)(void* owner, const unsigned char* callback, void* event);
+    void (*batchThunk)(void* owner, const unsigned char* callback, void* events, size_t count);
+    uint64_t subscriptionId;
+    alignas(std::max_align_t) unsigned char callback[MAX_CALLBACK_SIZE];
+
+    template <typename TOwner, typename TEvent>
+    static EventHandler Create(TOwner* owner, void (TOwner::*callbackFunction)(TEvent&)) {
         typedef void (TOwner::*CallbackFunction)(TEvent&);
+        EventHandler handler = CreateWithCallback(owner, callbackFunction);
+        handler.thunk = [](void* owner, const unsigned char* callback, void* event) {
+            CallbackFunction callbackFunction;
+            std::memcpy(&callbackFunction, callback, sizeof(CallbackFunction));
+            std::invoke(callbackFunction, static_cast<TOwner*>(owner), *static_cast<TEvent*>(event));
+        };
+        return handler;
+    }
 
-        TOwner* ownerInstance;
-        CallbackFunction callbackFunction;
+    template <typename TOwner, typename TEvent>
+    static EventHandler Create(TOwner* owner, void (TOwner::*callbackFunction)(EventSpan<TEvent>)) {
+        typedef void (TOwner::*CallbackFunction)(EventSpan<TEvent>);
+        EventHandler handler = CreateWithCallback(owner, callbackFunction);
+        handler.thunk = [](void* owner, const unsigned char* callback, void* event) {
+            CallbackFunction callbackFunction;
+            std::memcpy(&callbackFunction, callback, sizeof(CallbackFunction));
+            std::invoke(callbackFunction, static_cast<TOwner*>(owner), EventSpan<TEvent>(static_cast<TEvent*>(event), 1));
+        };
+        handler.batchThunk = [](void* owner, const unsigned char* callback, void* events, size_t count) {
+            CallbackFunction callbackFunction;
+            std::memcpy(&callbackFunction, callback, sizeof(CallbackFunction));
+            std::invoke(callbackFunction, static_cast<TOwner*>(owner), EventSpan<TEvent>(static_cast<TEvent*>(events), count));
+        };
+        return handler;
+    }
 
-        virtual void Call(Event& e) override {
-            std::invoke(callbackFunction, ownerInstance, static_cast<TEvent&>(e));
+    template <typename TOwner, typename TCallbackFunction>
+    static EventHandler CreateWithCallback(TOwner* owner, TCallbackFunction callbackFunction) {
+        static_assert(sizeof(TCallbackFunction) <= MAX_CALLBACK_SIZE, "Member function pointer too large for EventHandler");
+
+        EventHandler handler;
+        handler.owner = owner;
+        handler.thunk = nullptr;
+        handler.batchThunk = nullptr;
+        handler.subscriptionId = 0;
+        std::memcpy(handler.callback, &callbackFunction, sizeof(TCallbackFunction));
+        return handler;
+    }
+
+    template <typename TEvent>
+    void Execute(TEvent& event) const {
+        thunk(owner, callback, &event);
+    }
+
+    template <typename TEvent>
+    void ExecuteBatch(TEvent* events, size_t count) const {
+        batchThunk(owner, callback, events, count);
+    }
+};
+
+// === EventSubscription === //
+// Handle returned by EventBus::SubscribeToEvent, to unsubscribe later
+
+struct EventSubscription {
+    int eventId = -1;
+    uint64_t id = 0;
+};
+
+class EventBus;
+
+// === EventSubscriptions === //
+// The subscriptions of one owner. Destroying it unsubscribes them all, so a handler never
+// outlives its object; a bus destroyed first is simply skipped.
+
+class EventSubscriptions {
+    private:
+        struct Entry {
+            std::weak_ptr<EventBus*> bus;
+            EventSubscription subscription;
+        };
+
+        std::vector<Entry> entries;
+
+    public:
+        EventSubscriptions() = default;
+        EventSubscriptions(const EventSubscriptions&) = delete;
+        EventSubscriptions& operator =(const EventSubscriptions&) = delete;
+
+        ~EventSubscriptions() {
+            UnsubscribeAll();
         }
-    
+
+        void Add(EventBus& eventBus, EventSubscription subscription);
+        void UnsubscribeAll();
+
+        bool IsEmpty() const {
+            return entries.empty();
+        }
+};
+
+// === EventQueue === //
+// Events of one type waiting for EventBus::FlushEvents(). Every thread that queues gets a buffer of
+// its own, so producers never contend; the flush merges them and sorts the result with the event's
+// operator <, so the delivery order doesn't depend on which thread produced what. The sort is stable,
+// so events of one thread that compare equal stay in the order they were queued.
+// Events queued while a batch is delivered go to the producer buffers, not the batch.
+
+class IEventQueue {
+    public:
+        virtual ~IEventQueue() = default;
+        virtual bool IsEmpty() const = 0;
+        virtual void Flush(EventBus& eventBus) = 0;
+        virtual void Clear() = 0;
+};
+
+template <typename TEvent>
+class EventQueue: public IEventQueue {
+    private:
+        // Cache line aligned, so two threads queuing at once don't write to the same line
+        struct alignas(64) ProducerBuffer {
+            std::thread::id thread;
+            std::vector<TEvent> events;
+        };
+
+        std::vector<std::unique_ptr<ProducerBuffer>> producerBuffers;
+        std::vector<TEvent> deliveredEvents;
+
     public:
-        EventCallback(TOwner* ownerInstance, CallbackFunction callbackFunction) {
-            this->ownerInstance = ownerInstance;
-            this->callbackFunction = callbackFunction;
+        // The calling thread's buffer, created on its first call. The caller must hold the bus
+        // queue mutex; the buffer stays at the same address for the lifetime of the queue.
+        std::vector<TEvent>& GetProducerEvents() {
+            const std::thread::id thread = std::this_thread::get_id();
+            for (auto& producerBuffer: producerBuffers) {
+                if (producerBuffer->thread == thread) {
+                    return producerBuffer->events;
+                }
+            }
+            producerBuffers.push_back(std::make_unique<ProducerBuffer>());
+            producerBuffers.back()->thread = thread;
+            return producerBuffers.back()->events;
         }
 
-        virtual ~EventCallback() override = default;
+        bool IsEmpty() const override {
+            for (const auto& producerBuffer: producerBuffers) {
+                if (!producerBuffer->events.empty()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void Flush(EventBus& eventBus) override;
+
+        void Clear() override {
+            for (auto& producerBuffer: producerBuffers) {
+                producerBuffer->events.clear();
+            }
+        }
 };
 
-typedef std::list<std::unique_ptr<IEventCallback>> HandlerList;
+// === EventBus === //
+// Delivers events to the member functions subscribed to their type, either right away (EmitEvent)
+// or queued until FlushEvents() (QueueEvent), which hands each handler all events of a type at once.
+// Subscriptions persist until they are unsubscribed, their owner's EventSubscriptions is destroyed, or Reset().
 
 class EventBus {
     private:
-        std::map<std::type_index, std::unique_ptr<HandlerList>> subscribers;
+        // Vector index = event type id
+        std::vector<std::vector<EventHandler>> handlersPerEvent;
+        std::vector<std::unique_ptr<IEventQueue>> queuesPerEvent;
+
+        // Guards queuesPerEvent and the producer buffer lists, the first time a thread queues an event type
+        std::mutex queueMutex;
+
+        // Never reused, so a thread's cached producer buffer can't be mistaken for one of a newer bus
+        inline static std::atomic<uint64_t> nextBusId{1};
+        const uint64_t busId = nextBusId++;
+
+        uint64_t nextSubscriptionId = 1;
+
+        // Handlers unsubscribed during an emit are only marked, and removed once the outermost emit returns
+        int emitDepth = 0;
+        bool hasUnsubscribedHandlers = false;
+
+        // Handlers may queue more events while a flush delivers; they are delivered in the same flush
+        // unless they keep coming for this many rounds
+        static constexpr int MAX_FLUSH_PASSES = 4;
+
+        // Lets EventSubscriptions tell whether the bus still exists
+        std::shared_ptr<EventBus*> lifetimeToken = std::make_shared<EventBus*>(this);
+
+        friend class EventSubscriptions;
+        template <typename TEvent> friend class EventQueue;
+
+        std::vector<EventHandler>& GetHandlers(int eventId) {
+            if (eventId >= static_cast<int>(handlersPerEvent.size())) {
+                handlersPerEvent.resize(eventId + 1);
+            }
+            return handlersPerEvent[eventId];
+        }
+
+        template <typename TEvent>
+        EventQueue<TEvent>& GetQueue() {
+            const int eventId = EventType<TEvent>::GetId();
+            if (eventId >= static_cast<int>(queuesPerEvent.size())) {
+                queuesPerEvent.resize(eventId + 1);
+            }
+            if (!queuesPerEvent[eventId]) {
+                queuesPerEvent[eventId] = std::make_unique<EventQueue<TEvent>>();
+            }
+            return static_cast<EventQueue<TEvent>&>(*queuesPerEvent[eventId]);
+        }
+
+        template <typename TEvent, typename TOwner, typename TCallbackFunction>
+        EventSubscription AddHandler(TOwner* ownerInstance, TCallbackFunction callbackFunction, EventSubscriptions* subscriptions) {
+            EventSubscription subscription;
+            subscription.eventId = EventType<TEvent>::GetId();
+            subscription.id = nextSubscriptionId++;
+
+            EventHandler handler = EventHandler::Create(ownerInstance, callbackFunction);
+            handler.subscriptionId = subscription.id;
+            GetHandlers(subscription.eventId).push_back(handler);
+
+            if (subscriptions) {
+                subscriptions->Add(*this, subscription);
+            }
+            return subscription;
+        }
+
+        void RemoveUnsubscribedHandlers() {
+            for (auto& handlers: handlersPerEvent) {
+                handlers.erase(std::remove_if(handlers.begin(), handlers.end(), [](const EventHandler& handler) { return handler.thunk == nullptr; }), handlers.end());
+            }
+            hasUnsubscribedHandlers = false;
+        }
+
+        // Calls every handler of the event type with the run of queued events, in subscription order.
+        // Batch handlers get it in one call. The others get one event at a time and are looked up again
+        // for each, so unsubscribing stops the rest of the run and a reallocation in between is harmless.
+        template <typename TEvent>
+        void DeliverEvents(TEvent* events, size_t count) {
+            const int eventId = EventType<TEvent>::GetId();
+            if (count == 0 || eventId >= static_cast<int>(handlersPerEvent.size())) {
+                return;
+            }
+
+            emitDepth++;
+            const size_t numHandlers = handlersPerEvent[eventId].size();
+            for (size_t i = 0; i < numHandlers && i < handlersPerEvent[eventId].size(); i++) {
+                const EventHandler& handler = handlersPerEvent[eventId][i];
+                if (!handler.thunk) {
+                    continue;
+                }
+                if (handler.batchThunk) {
+                    handler.ExecuteBatch(events, count);
+                    continue;
+                }
+                for (size_t j = 0; j < count && handlersPerEvent[eventId][i].thunk; j++) {
+                    handlersPerEvent[eventId][i].Execute(events[j]);
+                }
+            }
+            emitDepth--;
+
+            if (emitDepth == 0 && hasUnsubscribedHandlers) {
+                RemoveUnsubscribedHandlers();
+            }
+        }
 
     public:
         EventBus() {
@@ -55,31 +348,160 @@ class EventBus {
             Logger::Log("EventBus destructor called.");
         }
 
+        // Drops every subscription and queued event; the vectors keep their capacity
         void Reset() {
-            subscribers.clear();
+            for (auto& handlers: handlersPerEvent) {
+                handlers.clear();
+            }
+            for (auto& queue: queuesPerEvent) {
+                if (queue) {
+                    queue->Clear();
+                }
+            }
+        }
+
+        // Subscriptions stay until unsubscribed; keep the handle, or pass the owner's EventSubscriptions
+        // to have them removed when the owner is destroyed
+        template <typename TEvent, typename TOwner>
+        EventSubscription SubscribeToEvent(TOwner* ownerInstance, void (TOwner::*callbackFunction)(TEvent&)) {
+            return AddHandler<TEvent>(ownerInstance, callbackFunction, nullptr);
+        }
+
+        template <typename TEvent, typename TOwner>
+        EventSubscription SubscribeToEvent(TOwner* ownerInstance, void (TOwner::*callbackFunction)(TEvent&), EventSubscriptions& subscriptions) {
+            return AddHandler<TEvent>(ownerInstance, callbackFunction, &subscriptions);
+        }
+
+        // Batch handlers get every queued event of the type in one call; an emitted event arrives as a span of one
+        template <typename TEvent, typename TOwner>
+        EventSubscription SubscribeToEvent(TOwner* ownerInstance, void (TOwner::*callbackFunction)(EventSpan<TEvent>)) {
+            return AddHandler<TEvent>(ownerInstance, callbackFunction, nullptr);
         }
 
         template <typename TEvent, typename TOwner>
-        void SubscribeToEvent(TOwner* ownerInstance, void (TOwner::*callbackFunction)(TEvent&)) {
-            if (!subscribers[typeid(TEvent)].get()) {
-                subscribers[typeid(TEvent)] = std::make_unique<HandlerList>();
+        EventSubscription SubscribeToEvent(TOwner* ownerInstance, void (TOwner::*callbackFunction)(EventSpan<TEvent>), EventSubscriptions& subscriptions) {
+            return AddHandler<TEvent>(ownerInstance, callbackFunction, &subscriptions);
+        }
+
+        // Unknown or already removed subscriptions are ignored
+        void Unsubscribe(EventSubscription subscription) {
+            if (subscription.eventId < 0 || subscription.eventId >= static_cast<int>(handlersPerEvent.size())) {
+                return;
+            }
+
+            auto& handlers = handlersPerEvent[subscription.eventId];
+            for (size_t i = 0; i < handlers.size(); i++) {
+                if (handlers[i].subscriptionId != subscription.id) {
+                    continue;
+                }
+
+                if (emitDepth > 0) {
+                    handlers[i].thunk = nullptr;
+                    hasUnsubscribedHandlers = true;
+                } else {
+                    handlers.erase(handlers.begin() + i);
+                }
+                return;
             }
-            
-            auto subscriber = std::make_unique<EventCallback<TOwner, TEvent>>(ownerInstance, callbackFunction);
-            subscribers[typeid(TEvent)]->push_back(std::move(subscriber));
         }
 
+        // Delivered right away. The event is built once and every handler receives the same instance.
         template <typename TEvent, typename ...TArgs>
         void EmitEvent(TArgs&& ...args) {
-            auto handlers = subscribers[typeid(TEvent)].get();
-            if (handlers) {
-                for (auto it = handlers->begin(); it != handlers->end(); it++) {
-                    auto handler = it->get();
-                    TEvent event(std::forward<TArgs>(args)...);
-                    handler->Execute(event);
+            const int eventId = EventType<TEvent>::GetId();
+            if (eventId >= static_cast<int>(handlersPerEvent.size()) || handlersPerEvent[eventId].empty()) {
+                return;
+            }
+
+            TEvent event(std::forward<TArgs>(args)...);
+
+            // Indexed, so handlers may subscribe while the event is delivered; they get the next one.
+            // The thunk copies the callback out before calling it, so a reallocation during the call is harmless.
+            emitDepth++;
+            const size_t numHandlers = handlersPerEvent[eventId].size();
+            for (size_t i = 0; i < numHandlers && i < handlersPerEvent[eventId].size(); i++) {
+                const EventHandler& handler = handlersPerEvent[eventId][i];
+                if (handler.thunk) {
+                    handler.Execute(event);
                 }
             }
+            emitDepth--;
+
+            if (emitDepth == 0 && hasUnsubscribedHandlers) {
+                RemoveUnsubscribedHandlers();
+            }
+        }
+
+        // Stored until the next FlushEvents(), so handlers never run in the middle of the emitter's loop.
+        // Unlike the rest of the bus this may be called from any thread, e.g. systems running in the same
+        // scheduler wave; after a thread's first event of a type it takes no lock.
+        template <typename TEvent, typename ...TArgs>
+        void QueueEvent(TArgs&& ...args) {
+            static_assert(IsEventOrdered<TEvent>::value, "Queued events need an operator < to be merged in a deterministic order");
+
+            struct ProducerCache {
+                uint64_t busId = 0;
+                std::vector<TEvent>* events = nullptr;
+            };
+            static thread_local ProducerCache producerCache;
+
+            if (producerCache.busId != busId) {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                producerCache.events = &GetQueue<TEvent>().GetProducerEvents();
+                producerCache.busId = busId;
+            }
+            producerCache.events->emplace_back(std::forward<TArgs>(args)...);
+        }
+
+        // Delivers the queued events one type at a time, in type id order, each type's events sorted.
+        // Every handler sees all events of the type before the next handler runs.
+        // Call it at a sync point, while no other thread is queuing.
+        void FlushEvents() {
+            for (int pass = 0; pass < MAX_FLUSH_PASSES; pass++) {
+                bool hasFlushed = false;
+                for (size_t eventId = 0; eventId < queuesPerEvent.size(); eventId++) {
+                    if (queuesPerEvent[eventId] && !queuesPerEvent[eventId]->IsEmpty()) {
+                        queuesPerEvent[eventId]->Flush(*this);
+                        hasFlushed = true;
+                    }
+                }
+                if (!hasFlushed) {
+                    return;
+                }
+            }
+            Logger::Err("Events were still being queued after " + std::to_string(MAX_FLUSH_PASSES) + " flush passes, the rest is delivered on the next flush.");
         }
 };
 
+template <typename TEvent>
+void EventQueue<TEvent>::Flush(EventBus& eventBus) {
+    for (auto& producerBuffer: producerBuffers) {
+        if (deliveredEvents.empty()) {
+            std::swap(deliveredEvents, producerBuffer->events);
+        } else {
+            deliveredEvents.insert(deliveredEvents.end(), std::make_move_iterator(producerBuffer->events.begin()), std::make_move_iterator(producerBuffer->events.end()));
+            producerBuffer->events.clear();
+        }
+    }
+    if (!std::is_sorted(deliveredEvents.begin(), deliveredEvents.end())) {
+        std::stable_sort(deliveredEvents.begin(), deliveredEvents.end());
+    }
+
+    eventBus.DeliverEvents(deliveredEvents.data(), deliveredEvents.size());
+    deliveredEvents.clear();
+}
+
+inline void EventSubscriptions::Add(EventBus& eventBus, EventSubscription subscription) {
+    entries.push_back({eventBus.lifetimeToken, subscription});
+}
+
+inline void EventSubscriptions::UnsubscribeAll() {
+    for (const auto& entry: entries) {
+        if (auto bus = entry.bus.lock()) {
+            (*bus)->Unsubscribe(entry.subscription);
+        }
+    }
+    entries.clear();
+}
+
 #endif
@@ -0,0 +1,18 @@
+#ifndef COLLISIONENTEREVENT_H
+#define COLLISIONENTEREVENT_H
+
+#include "../ECS/ECS.h"
+#include "../EventBus/Event.h"
+
+// Emitted on the first frame two colliders overlap
+class CollisionEnterEvent: public Event {
+    public:
+        Entity a;
+        Entity b;
+        CollisionEnterEvent(Entity a, Entity b): a(a), b(b) {}
+
+        // Queued events are delivered in this order
+        bool operator <(const CollisionEnterEvent& other) const { return a < other.a || (a == other.a && b < other.b); }
+};
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef COLLISIONEXITEVENT_H
+#define COLLISIONEXITEVENT_H
+
+#include "../ECS/ECS.h"
+#include "../EventBus/Event.h"
+
+// Emitted on the first frame two colliders stopped overlapping.
+// Either entity may have been killed in the meantime; check IsAlive() before touching its components.
+class CollisionExitEvent: public Event {
+    public:
+        Entity a;
+        Entity b;
+        CollisionExitEvent(Entity a, Entity b): a(a), b(b) {}
+
+        // Queued events are delivered in this order
+        bool operator <(const CollisionExitEvent& other) const { return a < other.a || (a == other.a && b < other.b); }
+};
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef COLLISIONSTAYEVENT_H
+#define COLLISIONSTAYEVENT_H
+
+#include "../ECS/ECS.h"
+#include "../EventBus/Event.h"
+
+// Emitted on every later frame two colliders keep overlapping, if enabled in the CollisionSystem
+class CollisionStayEvent: public Event {
+    public:
+        Entity a;
+        Entity b;
+        CollisionStayEvent(Entity a, Entity b): a(a), b(b) {}
+
+        // Queued events are delivered in this order
+        bool operator <(const CollisionStayEvent& other) const { return a < other.a || (a == other.a && b < other.b); }
+};
+
+#endif
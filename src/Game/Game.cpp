@@ -1,6 +1,7 @@
 #include "./Game.h"
 #include "./LevelLoader.h"
 #include "../Logger/Logger.h"
+#include "../Profiler/AllocationCounter.h"
 #include "../ECS/ECS.h"
 #include "../Systems/MovementSystem.h"
 #include "../Systems/CameraMovementSystem.h"
@@ -15,6 +16,7 @@
 #include "../Systems/RenderTextSystem.h"
 #include "../Systems/RenderHealthBarSystem.h"
 #include "../Systems/RenderGUISystem.h"
+#include "../Systems/SpatialIndexSystem.h"
 #include "../Systems/ScriptSystem.h"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
@@ -35,6 +37,8 @@ Game::Game() {
     registry = std::make_unique<Registry>();
     assetStore = std::make_unique<AssetStore>();
     eventBus = std::make_unique<EventBus>();
+    threadPool = std::make_unique<ThreadPool>();
+    scheduler = std::make_unique<SystemScheduler>(*threadPool);
     Logger::Log("Game constructor called.");
 }
 
@@ -99,9 +103,42 @@ void Game::Setup() {
     registry->AddSystem<RenderTextSystem>();
     registry->AddSystem<RenderHealthBarSystem>();
     registry->AddSystem<RenderGUISystem>();
+    registry->AddSystem<SpatialIndexSystem>();
     registry->AddSystem<ScriptSystem>();
 
-    registry->GetSystem<ScriptSystem>().CreateLuaBindings(lua);
+    registry->GetSystem<ScriptSystem>().CreateLuaBindings(lua, registry->GetSystem<SpatialIndexSystem>());
+
+    // Subscriptions persist for the lifetime of each system
+    registry->GetSystem<MovementSystem>().SubscribeToEvents(eventBus);
+    registry->GetSystem<DamageSystem>().SubscribeToEvents(eventBus);
+    registry->GetSystem<KeyboardControlSystem>().SubscribeToEvents(eventBus);
+    registry->GetSystem<ProjectileEmitSystem>().SubscribeToEvents(eventBus);
+
+    // Update order; systems with non-conflicting component access run in parallel
+    scheduler->AddSystem("MovementSystem", registry->GetSystem<MovementSystem>(), [this](double deltaTime) {
+        registry->GetSystem<MovementSystem>().Update(deltaTime, registry, *threadPool);
+    });
+    scheduler->AddSystem("AnimationSystem", registry->GetSystem<AnimationSystem>(), [this](double deltaTime) {
+        registry->GetSystem<AnimationSystem>().Update(registry, *threadPool);
+    });
+    scheduler->AddSystem("CollisionSystem", registry->GetSystem<CollisionSystem>(), [this](double deltaTime) {
+        registry->GetSystem<CollisionSystem>().Update(deltaTime, eventBus, registry);
+    });
+    scheduler->AddSystem("ProjectileEmitSystem", registry->GetSystem<ProjectileEmitSystem>(), [this](double deltaTime) {
+        registry->GetSystem<ProjectileEmitSystem>().Update(registry);
+    });
+    scheduler->AddSystem("CameraMovementSystem", registry->GetSystem<CameraMovementSystem>(), [this](double deltaTime) {
+        registry->GetSystem<CameraMovementSystem>().Update(camera);
+    });
+    scheduler->AddSystem("ProjectileLifecycleSystem", registry->GetSystem<ProjectileLifecycleSystem>(), [this](double deltaTime) {
+        registry->GetSystem<ProjectileLifecycleSystem>().Update();
+    });
+    scheduler->AddSystem("SpatialIndexSystem", registry->GetSystem<SpatialIndexSystem>(), [this](double deltaTime) {
+        registry->GetSystem<SpatialIndexSystem>().Update(registry);
+    });
+    scheduler->AddSystem("ScriptSystem", registry->GetSystem<ScriptSystem>(), [this](double deltaTime) {
+        registry->GetSystem<ScriptSystem>().Update(deltaTime, SDL_GetTicks());
+    });
 
     LevelLoader loader;
     lua.open_libraries(sol::lib::base, sol::lib::math, sol::lib::os);
@@ -148,34 +185,24 @@ void Game::Update() {
     // Store the current frame time
     millisecsPreviousFrame = SDL_GetTicks();
 
-    eventBus->Reset();
-
-    registry->GetSystem<MovementSystem>().SubscribeToEvents(eventBus);
-    registry->GetSystem<DamageSystem>().SubscribeToEvents(eventBus);
-    registry->GetSystem<KeyboardControlSystem>().SubscribeToEvents(eventBus);
-    registry->GetSystem<ProjectileEmitSystem>().SubscribeToEvents(eventBus);
-
     registry->Update();
 
-    registry->GetSystem<MovementSystem>().Update(deltaTime);
-    registry->GetSystem<AnimationSystem>().Update();
-    registry->GetSystem<CollisionSystem>().Update(eventBus);
-    registry->GetSystem<ProjectileEmitSystem>().Update(registry);
-    registry->GetSystem<CameraMovementSystem>().Update(camera);
-    registry->GetSystem<ProjectileLifecycleSystem>().Update();
-    registry->GetSystem<ScriptSystem>().Update(deltaTime, SDL_GetTicks());
+    scheduler->Run(deltaTime);
+
+    // Events queued by the systems (e.g. collisions) are handled once every system is done
+    eventBus->FlushEvents();
 }
 
 void Game::Render() {
     SDL_SetRenderDrawColor(renderer, 21, 21, 21, 255);
     SDL_RenderClear(renderer);
 
-    registry->GetSystem<RenderSystem>().Update(renderer, assetStore, camera);
+    registry->GetSystem<RenderSystem>().Update(renderer, assetStore, camera, registry);
     registry->GetSystem<RenderTextSystem>().Update(renderer, assetStore, camera);
-    registry->GetSystem<RenderHealthBarSystem>().Update(renderer, assetStore, camera);
+    registry->GetSystem<RenderHealthBarSystem>().Update(renderer, assetStore, camera, registry);
     if (isDebug) {
         registry->GetSystem<RenderColliderSystem>().Update(renderer, camera);
-        registry->GetSystem<RenderGUISystem>().Update(registry, camera);
+        registry->GetSystem<RenderGUISystem>().Update(registry, camera, scheduler);
     }
 
     SDL_RenderPresent(renderer);
@@ -185,6 +212,7 @@ void Game::Run() {
     Setup();
     while (isRunning)
     {
+        AllocationCounter::NewFrame();
         ProcessInput();
         Update();
         Render();
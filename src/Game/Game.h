@@ -4,6 +4,8 @@
 #include "../ECS/ECS.h"
 #include "../AssetStore/AssetStore.h"
 #include "../EventBus/EventBus.h"
+#include "../Scheduler/ThreadPool.h"
+#include "../Scheduler/SystemScheduler.h"
 #include <SDL2/SDL.h>
 #include <sol/sol.hpp>
 
@@ -24,6 +26,8 @@ class Game {
         std::unique_ptr<Registry> registry;
         std::unique_ptr<AssetStore> assetStore;
         std::unique_ptr<EventBus> eventBus;
+        std::unique_ptr<ThreadPool> threadPool;
+        std::unique_ptr<SystemScheduler> scheduler;
 
     public:
         Game();
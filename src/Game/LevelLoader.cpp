@@ -11,10 +11,48 @@
 #include "../Components/HealthComponent.h"
 #include "../Components/TextLabelComponent.h"
 #include "../Components/ScriptComponent.h"
+#include "../Systems/CollisionSystem.h"
+#include "../Systems/SpatialIndexSystem.h"
 #include <fstream>
 #include <string>
+#include <unordered_map>
 #include <sol/sol.hpp>
 
+uint32_t LevelLoader::ParseCollisionLayers(const sol::object& value, uint32_t defaultLayers) {
+    static const std::unordered_map<std::string, uint32_t> layersPerName = {
+        {"default", COLLISION_LAYER_DEFAULT},
+        {"player", COLLISION_LAYER_PLAYER},
+        {"enemy", COLLISION_LAYER_ENEMY},
+        {"projectile", COLLISION_LAYER_PROJECTILE},
+        {"obstacle", COLLISION_LAYER_OBSTACLE},
+        {"all", COLLISION_LAYER_ALL}
+    };
+
+    std::vector<std::string> names;
+    if (value.is<std::string>()) {
+        names.push_back(value.as<std::string>());
+    } else if (value.is<sol::table>()) {
+        for (const auto& item: value.as<sol::table>()) {
+            if (item.second.is<std::string>()) {
+                names.push_back(item.second.as<std::string>());
+            }
+        }
+    } else {
+        return defaultLayers;
+    }
+
+    uint32_t layers = 0;
+    for (const auto& name: names) {
+        auto layer = layersPerName.find(name);
+        if (layer == layersPerName.end()) {
+            Logger::Err("Unknown collision layer " + name + ".");
+            continue;
+        }
+        layers |= layer->second;
+    }
+    return layers;
+}
+
 LevelLoader::LevelLoader() {
     Logger::Log("LevelLoader constructor called!");    
 }
@@ -69,6 +107,12 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
     double mapScale = map["scale"];
     std::fstream mapFile;
     mapFile.open(mapFilePath);
+
+    // Spawn all the tiles in one batch, then fill in the per-tile position and source rectangle
+    std::vector<Entity> tiles = registry->CreateEntities(mapNumRows * mapNumCols);
+    registry->AddComponents<TransformComponent>(tiles, glm::vec2(0, 0), glm::vec2(mapScale, mapScale), 0.0);
+    registry->AddComponents<SpriteComponent>(tiles, mapTextureAssetId, tileSize, tileSize, 0, false);
+
     for (int y = 0; y < mapNumRows; y++) {
         for (int x = 0; x < mapNumCols; x++) {
             char ch;
@@ -78,15 +122,26 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
             int srcRectX = std::atoi(&ch) * tileSize;
             mapFile.ignore();
 
-            Entity tile = registry->CreateEntity();
-            tile.AddComponent<TransformComponent>(glm::vec2(x * (mapScale * tileSize), y * (mapScale * tileSize)), glm::vec2(mapScale, mapScale), 0.0);
-            tile.AddComponent<SpriteComponent>(mapTextureAssetId, tileSize, tileSize, 0, false, srcRectX, srcRectY);
+            Entity tile = tiles[y * mapNumCols + x];
+            auto& transform = tile.GetComponent<TransformComponent>();
+            transform.position = glm::vec2(x * (mapScale * tileSize), y * (mapScale * tileSize));
+            auto& sprite = tile.GetComponent<SpriteComponent>();
+            sprite.srcRect.x = srcRectX;
+            sprite.srcRect.y = srcRectY;
         }
     }
     mapFile.close();
     Game::mapWidth = mapNumCols * tileSize * mapScale;
     Game::mapHeight = mapNumRows * tileSize * mapScale;
 
+    // Size the collision and spatial index grid cells to one map tile
+    if (registry->HasSystem<CollisionSystem>()) {
+        registry->GetSystem<CollisionSystem>().SetCellSize(tileSize * mapScale);
+    }
+    if (registry->HasSystem<SpatialIndexSystem>()) {
+        registry->GetSystem<SpatialIndexSystem>().SetCellSize(tileSize * mapScale);
+    }
+
     // Entities and components
     sol::table entities = level["entities"];
     i = 0;
@@ -174,7 +229,13 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
                     glm::vec2(
                         entity["components"]["boxcollider"]["offset"]["x"].get_or(0),
                         entity["components"]["boxcollider"]["offset"]["y"].get_or(0)
-                    )
+                    ),
+                    CollisionFilter(
+                        ParseCollisionLayers(entity["components"]["boxcollider"]["category"], COLLISION_LAYER_DEFAULT),
+                        ParseCollisionLayers(entity["components"]["boxcollider"]["mask"], COLLISION_LAYER_ALL)
+                    ),
+                    entity["components"]["boxcollider"]["fast"].get_or(false),
+                    entity["components"]["boxcollider"]["static"].get_or(false)
                 );
             }
             
@@ -6,12 +6,17 @@
 #include <SDL2/SDL.h>
 #include <sol/sol.hpp>
 #include <memory>
+#include <cstdint>
 
 class LevelLoader {
     public:
         LevelLoader();
         ~LevelLoader();
         void LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetStore>& assetStore, SDL_Renderer* renderer, int level);
+
+        // Collision layers are given by name, either one ("enemy") or a list ({ "projectile", "obstacle" }).
+        // Missing values fall back to defaultLayers.
+        static uint32_t ParseCollisionLayers(const sol::object& value, uint32_t defaultLayers);
 };
 
 #endif
@@ -4,6 +4,7 @@
 #include <ctime>
 #include <chrono>
 #include <string>
+#include <mutex>
 
 #define ESC "\033["
 #define GREEN_TEXT "32m"
@@ -12,6 +13,9 @@
 
 std::vector<LogEntry> Logger::messages;
 
+// Systems can log from worker threads, and localtime() isn't thread safe either
+static std::mutex messagesMutex;
+
 std::string CurrentDateTimeToString() {
     std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
     std::string output(30, '\0');
@@ -20,6 +24,7 @@ std::string CurrentDateTimeToString() {
 }
 
 void Logger::Log(const std::string& message) {
+    std::lock_guard<std::mutex> lock(messagesMutex);
     LogEntry logEntry;
     logEntry.type = LOG_INFO;
     logEntry.message = "LOG | " + CurrentDateTimeToString() + " - " + message; 
@@ -28,6 +33,7 @@ void Logger::Log(const std::string& message) {
 }
 
 void Logger::Err(const std::string& message) {
+    std::lock_guard<std::mutex> lock(messagesMutex);
     LogEntry logEntry;
     logEntry.type = LOG_ERROR;
     logEntry.message = "ERR | " + CurrentDateTimeToString() + " - " + message;
@@ -0,0 +1,64 @@
+#ifndef AABB_H
+#define AABB_H
+
+#include <algorithm>
+#include <utility>
+
+// Axis-aligned bounding box in world coordinates
+struct AABB {
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+
+    AABB(float minX = 0, float minY = 0, float maxX = 0, float maxY = 0) {
+        this->minX = minX;
+        this->minY = minY;
+        this->maxX = maxX;
+        this->maxY = maxY;
+    }
+
+    // Boxes that only touch along an edge don't overlap
+    bool Overlaps(const AABB& other) const {
+        return (
+            minX < other.maxX &&
+            maxX > other.minX &&
+            minY < other.maxY &&
+            maxY > other.minY
+        );
+    }
+
+    // Moves this box by (dx, dy) against a resting box. Returns whether they overlap at some point
+    // during the move, with the fraction of the move at which they first do in timeOfImpact.
+    // Catches fast boxes that would pass through the other one between two frames.
+    bool Sweep(float dx, float dy, const AABB& other, float& timeOfImpact) const {
+        float entry = 0;
+        float exit = 1;
+        if (!SweepAxis(minX, maxX, dx, other.minX, other.maxX, entry, exit) ||
+            !SweepAxis(minY, maxY, dy, other.minY, other.maxY, entry, exit)) {
+            return false;
+        }
+        timeOfImpact = entry;
+        return true;
+    }
+
+    private:
+        // Narrows [entry, exit] to the part of the move where the intervals overlap on one axis
+        static bool SweepAxis(float min, float max, float delta, float otherMin, float otherMax, float& entry, float& exit) {
+            if (delta == 0) {
+                return min < otherMax && max > otherMin;
+            }
+
+            float axisEntry = (otherMin - max) / delta;
+            float axisExit = (otherMax - min) / delta;
+            if (delta < 0) {
+                std::swap(axisEntry, axisExit);
+            }
+
+            entry = std::max(entry, axisEntry);
+            exit = std::min(exit, axisExit);
+            return entry < exit;
+        }
+};
+
+#endif
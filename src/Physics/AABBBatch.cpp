@@ -0,0 +1,106 @@
+#include "AABBBatch.h"
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+void AABBBatch::Clear() {
+    minX.clear();
+    minY.clear();
+    maxX.clear();
+    maxY.clear();
+}
+
+void AABBBatch::Reserve(size_t capacity) {
+    minX.reserve(capacity);
+    minY.reserve(capacity);
+    maxX.reserve(capacity);
+    maxY.reserve(capacity);
+}
+
+void AABBBatch::Add(const AABB& box) {
+    minX.push_back(box.minX);
+    minY.push_back(box.minY);
+    maxX.push_back(box.maxX);
+    maxY.push_back(box.maxY);
+}
+
+size_t AABBBatch::GetSize() const {
+    return minX.size();
+}
+
+void AABBBatch::FindOverlapsScalar(const AABB& box, size_t begin, size_t end, std::vector<int>& overlaps) const {
+    for (size_t i = begin; i < end; i++) {
+        if (box.minX < maxX[i] && box.maxX > minX[i] && box.minY < maxY[i] && box.maxY > minY[i]) {
+            overlaps.push_back(static_cast<int>(i));
+        }
+    }
+}
+
+#if defined(__AVX__)
+
+void AABBBatch::FindOverlaps(const AABB& box, size_t begin, size_t end, std::vector<int>& overlaps) const {
+    const __m256 boxMinX = _mm256_set1_ps(box.minX);
+    const __m256 boxMinY = _mm256_set1_ps(box.minY);
+    const __m256 boxMaxX = _mm256_set1_ps(box.maxX);
+    const __m256 boxMaxY = _mm256_set1_ps(box.maxY);
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        // Ordered, non-signaling compares: NaN coordinates never overlap, as in the scalar test
+        __m256 overlap = _mm256_cmp_ps(boxMinX, _mm256_loadu_ps(&maxX[i]), _CMP_LT_OQ);
+        overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(boxMaxX, _mm256_loadu_ps(&minX[i]), _CMP_GT_OQ));
+        overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(boxMinY, _mm256_loadu_ps(&maxY[i]), _CMP_LT_OQ));
+        overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(boxMaxY, _mm256_loadu_ps(&minY[i]), _CMP_GT_OQ));
+
+        // One bit per lane; most batches have no hit at all
+        for (int mask = _mm256_movemask_ps(overlap); mask != 0; mask &= mask - 1) {
+            overlaps.push_back(static_cast<int>(i) + __builtin_ctz(mask));
+        }
+    }
+
+    FindOverlapsScalar(box, i, end, overlaps);
+}
+
+const char* AABBBatch::GetInstructionSet() {
+    return "AVX";
+}
+
+#elif defined(__SSE2__)
+
+void AABBBatch::FindOverlaps(const AABB& box, size_t begin, size_t end, std::vector<int>& overlaps) const {
+    const __m128 boxMinX = _mm_set1_ps(box.minX);
+    const __m128 boxMinY = _mm_set1_ps(box.minY);
+    const __m128 boxMaxX = _mm_set1_ps(box.maxX);
+    const __m128 boxMaxY = _mm_set1_ps(box.maxY);
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 overlap = _mm_cmplt_ps(boxMinX, _mm_loadu_ps(&maxX[i]));
+        overlap = _mm_and_ps(overlap, _mm_cmpgt_ps(boxMaxX, _mm_loadu_ps(&minX[i])));
+        overlap = _mm_and_ps(overlap, _mm_cmplt_ps(boxMinY, _mm_loadu_ps(&maxY[i])));
+        overlap = _mm_and_ps(overlap, _mm_cmpgt_ps(boxMaxY, _mm_loadu_ps(&minY[i])));
+
+        for (int mask = _mm_movemask_ps(overlap); mask != 0; mask &= mask - 1) {
+            overlaps.push_back(static_cast<int>(i) + __builtin_ctz(mask));
+        }
+    }
+
+    FindOverlapsScalar(box, i, end, overlaps);
+}
+
+const char* AABBBatch::GetInstructionSet() {
+    return "SSE2";
+}
+
+#else
+
+void AABBBatch::FindOverlaps(const AABB& box, size_t begin, size_t end, std::vector<int>& overlaps) const {
+    FindOverlapsScalar(box, begin, end, overlaps);
+}
+
+const char* AABBBatch::GetInstructionSet() {
+    return "scalar";
+}
+
+#endif
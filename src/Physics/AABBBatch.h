@@ -0,0 +1,38 @@
+#ifndef AABBBATCH_H
+#define AABBBATCH_H
+
+#include "AABB.h"
+#include <vector>
+#include <cstddef>
+
+// === AABBBatch === //
+// Boxes stored as four separate float arrays (structure of arrays), so the overlap kernel
+// tests 8 boxes per instruction with AVX, 4 with SSE, and falls back to a scalar loop elsewhere.
+// The instruction set is picked at compile time: build with -mavx2 (or -march=native) for AVX.
+
+class AABBBatch {
+    private:
+        std::vector<float> minX;
+        std::vector<float> minY;
+        std::vector<float> maxX;
+        std::vector<float> maxY;
+
+    public:
+        AABBBatch() = default;
+
+        void Clear();
+        void Reserve(size_t capacity);
+        void Add(const AABB& box);
+        size_t GetSize() const;
+
+        // Append to overlaps the index of every box in [begin, end) that overlaps box, in index order
+        void FindOverlaps(const AABB& box, size_t begin, size_t end, std::vector<int>& overlaps) const;
+
+        // Same result without SIMD, one box at a time
+        void FindOverlapsScalar(const AABB& box, size_t begin, size_t end, std::vector<int>& overlaps) const;
+
+        // Name of the instruction set FindOverlaps() was compiled for
+        static const char* GetInstructionSet();
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef COLLISIONFILTER_H
+#define COLLISIONFILTER_H
+
+#include <cstdint>
+
+// Layers a collider can belong to, one bit each
+enum CollisionLayer: uint32_t {
+    COLLISION_LAYER_DEFAULT = 1 << 0,
+    COLLISION_LAYER_PLAYER = 1 << 1,
+    COLLISION_LAYER_ENEMY = 1 << 2,
+    COLLISION_LAYER_PROJECTILE = 1 << 3,
+    COLLISION_LAYER_OBSTACLE = 1 << 4,
+    COLLISION_LAYER_ALL = 0xFFFFFFFF
+};
+
+// Category is the set of layers a collider is on, mask the layers it collides with.
+// Two colliders only collide if each one's category is in the other's mask.
+struct CollisionFilter {
+    uint32_t category;
+    uint32_t mask;
+
+    CollisionFilter(uint32_t category = COLLISION_LAYER_DEFAULT, uint32_t mask = COLLISION_LAYER_ALL) {
+        this->category = category;
+        this->mask = mask;
+    }
+
+    bool CanCollideWith(const CollisionFilter& other) const {
+        return (category & other.mask) != 0 && (other.category & mask) != 0;
+    }
+};
+
+#endif
@@ -0,0 +1,35 @@
+#include "ContactTracker.h"
+#include <algorithm>
+
+void ContactTracker::BeginFrame() {
+    frame++;
+}
+
+bool ContactTracker::Touch(uint64_t a, uint64_t b) {
+    const Contact key = {std::min(a, b), std::max(a, b)};
+
+    auto [state, isNew] = contacts.try_emplace(key, ContactState{{a, b}, frame});
+    state->second.lastFrame = frame;
+    return isNew;
+}
+
+const std::vector<ContactTracker::Contact>& ContactTracker::EndFrame() {
+    endedContacts.clear();
+
+    for (auto state = contacts.begin(); state != contacts.end();) {
+        if (state->second.lastFrame != frame) {
+            endedContacts.push_back(state->second.contact);
+            state = contacts.erase(state);
+        } else {
+            state++;
+        }
+    }
+
+    // Hash order changes with the table size, so sort to report exits in a stable order
+    std::sort(endedContacts.begin(), endedContacts.end());
+    return endedContacts;
+}
+
+size_t ContactTracker::GetNumContacts() const {
+    return contacts.size();
+}
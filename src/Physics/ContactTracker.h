@@ -0,0 +1,57 @@
+#ifndef CONTACTTRACKER_H
+#define CONTACTTRACKER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include <functional>
+
+// === ContactTracker === //
+// Remembers which pairs of bodies touched on previous frames, so a collision can be reported
+// once when it starts and once when it ends instead of on every frame of the overlap.
+// Bodies are identified by any unique 64-bit key, e.g. entity id and generation.
+
+class ContactTracker {
+    public:
+        struct Contact {
+            uint64_t a;
+            uint64_t b;
+
+            bool operator ==(const Contact& other) const { return a == other.a && b == other.b; }
+            bool operator <(const Contact& other) const { return a < other.a || (a == other.a && b < other.b); }
+        };
+
+    private:
+        struct ContactHash {
+            size_t operator()(const Contact& contact) const {
+                return std::hash<uint64_t>()(contact.a * 0x9E3779B97F4A7C15ull ^ contact.b);
+            }
+        };
+
+        struct ContactState {
+            // Bodies in the order they were first reported
+            Contact contact;
+            int lastFrame;
+        };
+
+        // Keyed by the pair with the smaller key first, so (a, b) and (b, a) are the same contact
+        std::unordered_map<Contact, ContactState, ContactHash> contacts;
+        std::vector<Contact> endedContacts;
+        int frame = 0;
+
+    public:
+        ContactTracker() = default;
+
+        void BeginFrame();
+
+        // Record that a and b touch this frame. Returns true on the first frame of the contact.
+        bool Touch(uint64_t a, uint64_t b);
+
+        // Forget the contacts that weren't touched since BeginFrame() and return them, sorted
+        const std::vector<Contact>& EndFrame();
+
+        size_t GetNumContacts() const;
+};
+
+#endif
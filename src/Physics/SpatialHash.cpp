@@ -0,0 +1,100 @@
+#include "SpatialHash.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialHash::SpatialHash(float cellSize) {
+    SetCellSize(cellSize);
+}
+
+void SpatialHash::SetCellSize(float cellSize) {
+    if (!(cellSize > 0)) {
+        Logger::Err("Invalid spatial hash cell size " + std::to_string(cellSize) + ", keeping " + std::to_string(this->cellSize) + ".");
+        return;
+    }
+    this->cellSize = cellSize;
+}
+
+float SpatialHash::GetCellSize() const {
+    return cellSize;
+}
+
+int SpatialHash::GetCellCoordinate(float position) const {
+    return static_cast<int>(std::floor(position / cellSize));
+}
+
+uint64_t SpatialHash::GetCellKey(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+const std::vector<std::pair<int, int>>& SpatialHash::FindOverlappingPairs(const std::vector<AABB>& boxes, const std::vector<CollisionFilter>& filters) {
+    cellRanges.resize(boxes.size());
+    entries.clear();
+    pairs.clear();
+
+    for (size_t i = 0; i < boxes.size(); i++) {
+        // Boxes that collide with nothing never need to be binned
+        if (filters[i].mask == 0 || filters[i].category == 0) {
+            continue;
+        }
+
+        const AABB& box = boxes[i];
+        CellRange& range = cellRanges[i];
+        range.minX = GetCellCoordinate(box.minX);
+        range.minY = GetCellCoordinate(box.minY);
+        range.maxX = GetCellCoordinate(box.maxX);
+        range.maxY = GetCellCoordinate(box.maxY);
+
+        for (int x = range.minX; x <= range.maxX; x++) {
+            for (int y = range.minY; y <= range.maxY; y++) {
+                entries.push_back({GetCellKey(x, y), static_cast<int>(i)});
+            }
+        }
+    }
+
+    // Sorting groups the boxes of each cell into one contiguous run
+    std::sort(entries.begin(), entries.end());
+
+    // Lay the boxes out in entry order, so the boxes of a cell are contiguous for the kernel
+    cellBoxes.Clear();
+    cellBoxes.Reserve(entries.size());
+    for (const auto& entry: entries) {
+        cellBoxes.Add(boxes[entry.box]);
+    }
+
+    for (size_t begin = 0; begin < entries.size();) {
+        size_t end = begin + 1;
+        while (end < entries.size() && entries[end].cell == entries[begin].cell) {
+            end++;
+        }
+
+        for (size_t i = begin; i < end; i++) {
+            const CellRange& a = cellRanges[entries[i].box];
+            const CollisionFilter& aFilter = filters[entries[i].box];
+
+            overlaps.clear();
+            cellBoxes.FindOverlaps(boxes[entries[i].box], i + 1, end, overlaps);
+
+            for (int j: overlaps) {
+                const int bBox = entries[j].box;
+                if (!aFilter.CanCollideWith(filters[bBox])) {
+                    continue;
+                }
+
+                // Two boxes can share several cells; only the first shared cell reports the pair
+                const CellRange& b = cellRanges[bBox];
+                const uint64_t firstSharedCell = GetCellKey(std::max(a.minX, b.minX), std::max(a.minY, b.minY));
+                if (firstSharedCell == entries[begin].cell) {
+                    pairs.emplace_back(entries[i].box, bBox);
+                }
+            }
+        }
+
+        begin = end;
+    }
+
+    // Report pairs in the same order as a plain nested loop over the boxes would
+    std::sort(pairs.begin(), pairs.end());
+
+    return pairs;
+}
@@ -0,0 +1,57 @@
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+
+#include "AABB.h"
+#include "CollisionFilter.h"
+#include "AABBBatch.h"
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+// === SpatialHash === //
+// Uniform grid broad phase. Every box is binned into the cells it covers, and only boxes
+// sharing a cell are tested against each other, with the batch overlap kernel.
+// The grid is rebuilt from scratch on each query, into buffers that are kept between frames
+// so steady-state queries don't allocate.
+
+class SpatialHash {
+    private:
+        struct CellEntry {
+            uint64_t cell;
+            int box;
+
+            bool operator <(const CellEntry& other) const {
+                return cell < other.cell || (cell == other.cell && box < other.box);
+            }
+        };
+
+        struct CellRange {
+            int minX;
+            int minY;
+            int maxX;
+            int maxY;
+        };
+
+        float cellSize = 64;
+
+        std::vector<CellRange> cellRanges;
+        std::vector<CellEntry> entries;
+        AABBBatch cellBoxes;
+        std::vector<int> overlaps;
+        std::vector<std::pair<int, int>> pairs;
+
+        int GetCellCoordinate(float position) const;
+        static uint64_t GetCellKey(int x, int y);
+
+    public:
+        SpatialHash(float cellSize = 64);
+
+        // Cells should be about the size of the typical box, e.g. one map tile
+        void SetCellSize(float cellSize);
+        float GetCellSize() const;
+
+        // Pairs (i, j) with i < j of boxes that overlap and whose filters accept each other, sorted
+        const std::vector<std::pair<int, int>>& FindOverlappingPairs(const std::vector<AABB>& boxes, const std::vector<CollisionFilter>& filters);
+};
+
+#endif
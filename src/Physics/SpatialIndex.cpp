@@ -0,0 +1,116 @@
+#include "SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+
+// Squared distance from a point to the closest point of a box, 0 inside it
+static float GetDistanceSquared(const AABB& box, float x, float y) {
+    const float dx = std::max(std::max(box.minX - x, x - box.maxX), 0.0f);
+    const float dy = std::max(std::max(box.minY - y, y - box.maxY), 0.0f);
+    return dx * dx + dy * dy;
+}
+
+void SpatialIndex::SetCellSize(float cellSize) {
+    grid.SetCellSize(cellSize);
+}
+
+void SpatialIndex::Build(const std::vector<AABB>& boxes, const std::vector<uint32_t>& categories) {
+    filters.clear();
+    for (uint32_t category: categories) {
+        filters.emplace_back(category, COLLISION_LAYER_ALL);
+    }
+    grid.Build(boxes, filters);
+}
+
+size_t SpatialIndex::GetSize() const {
+    return grid.GetSize();
+}
+
+void SpatialIndex::QueryGrid(const AABB& box, uint32_t layers) {
+    candidates.clear();
+    grid.Query(box, CollisionFilter(COLLISION_LAYER_ALL, layers), candidates);
+}
+
+void SpatialIndex::QueryAABB(const AABB& box, uint32_t layers, std::vector<int>& items) {
+    QueryGrid(box, layers);
+    items.insert(items.end(), candidates.begin(), candidates.end());
+}
+
+void SpatialIndex::QueryRadius(float x, float y, float radius, uint32_t layers, std::vector<int>& items) {
+    QueryGrid(AABB(x - radius, y - radius, x + radius, y + radius), layers);
+
+    const auto& boxes = grid.GetBoxes();
+    for (int item: candidates) {
+        if (GetDistanceSquared(boxes[item], x, y) < radius * radius) {
+            items.push_back(item);
+        }
+    }
+}
+
+bool SpatialIndex::Raycast(float x1, float y1, float x2, float y2, uint32_t layers, int ignoredItem, RaycastHit& hit) {
+    const auto& boxes = grid.GetBoxes();
+    const float dx = x2 - x1;
+    const float dy = y2 - y1;
+    const AABB origin(x1, y1, x1, y1);
+
+    // Walk the ray one cell length at a time. The nearest hit is in the first stretch that
+    // has any hit at all, so the search stops there instead of collecting the whole ray.
+    const float length = std::sqrt(dx * dx + dy * dy);
+    const int numSteps = std::max(1, static_cast<int>(std::ceil(length / grid.GetCellSize())));
+    for (int step = 0; step < numSteps; step++) {
+        const float begin = static_cast<float>(step) / numSteps;
+        const float end = static_cast<float>(step + 1) / numSteps;
+        QueryGrid(AABB(
+            x1 + std::min(dx * begin, dx * end), y1 + std::min(dy * begin, dy * end),
+            x1 + std::max(dx * begin, dx * end), y1 + std::max(dy * begin, dy * end)
+        ), layers);
+
+        // A hit exactly at the end of the stretch counts, as it does for AABB::Sweep
+        hit.item = -1;
+        hit.fraction = end;
+        for (int item: candidates) {
+            float fraction;
+            if (item != ignoredItem && origin.Sweep(dx, dy, boxes[item], fraction) && fraction <= hit.fraction) {
+                if (hit.item == -1 || fraction < hit.fraction || item < hit.item) {
+                    hit.item = item;
+                    hit.fraction = fraction;
+                }
+            }
+        }
+
+        if (hit.item != -1) {
+            hit.x = x1 + dx * hit.fraction;
+            hit.y = y1 + dy * hit.fraction;
+            return true;
+        }
+    }
+    return false;
+}
+
+int SpatialIndex::FindNearest(float x, float y, float maxDistance, uint32_t layers, int ignoredItem) {
+    const auto& boxes = grid.GetBoxes();
+    if (boxes.empty() || !(maxDistance > 0)) {
+        return -1;
+    }
+
+    // Search squares of growing size; a box found within the square's half size can't be
+    // beaten by anything outside it
+    float radius = std::min(grid.GetCellSize(), maxDistance);
+    while (true) {
+        QueryGrid(AABB(x - radius, y - radius, x + radius, y + radius), layers);
+
+        int nearest = -1;
+        float nearestDistanceSquared = radius * radius;
+        for (int item: candidates) {
+            const float distanceSquared = GetDistanceSquared(boxes[item], x, y);
+            if (item != ignoredItem && (distanceSquared < nearestDistanceSquared || (distanceSquared == nearestDistanceSquared && item < nearest))) {
+                nearest = item;
+                nearestDistanceSquared = distanceSquared;
+            }
+        }
+
+        if (nearest != -1 || radius >= maxDistance) {
+            return nearest;
+        }
+        radius = std::min(radius * 2, maxDistance);
+    }
+}
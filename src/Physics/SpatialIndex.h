@@ -0,0 +1,57 @@
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include "AABB.h"
+#include "CollisionFilter.h"
+#include "StaticGrid.h"
+#include <vector>
+#include <cstdint>
+
+// === SpatialIndex === //
+// Answers "what is around here" questions about a set of boxes: everything in a rectangle or
+// circle, the first box along a ray, and the nearest box to a point. Boxes are binned in a grid
+// that is rebuilt once per frame, so a query only visits the cells around it instead of every box.
+// Queries only report boxes on one of the given layers, and skip ignoredItem (e.g. the caller itself).
+
+class SpatialIndex {
+    public:
+        struct RaycastHit {
+            int item;
+            // Fraction of the ray, from 0 at the start to 1 at the end, and the point where it enters the box
+            float fraction;
+            float x;
+            float y;
+        };
+
+    private:
+        StaticGrid grid;
+        std::vector<CollisionFilter> filters;
+        std::vector<int> candidates;
+
+        // Finds boxes on the given layers, relying on every box accepting any query in its mask
+        void QueryGrid(const AABB& box, uint32_t layers);
+
+    public:
+        SpatialIndex() = default;
+
+        // Cells should be about the size of the typical box, e.g. one map tile
+        void SetCellSize(float cellSize);
+
+        // categories[i] holds the collision layers of boxes[i]; item i is reported for boxes[i]
+        void Build(const std::vector<AABB>& boxes, const std::vector<uint32_t>& categories);
+        size_t GetSize() const;
+
+        // Append the boxes overlapping box to items, each one once
+        void QueryAABB(const AABB& box, uint32_t layers, std::vector<int>& items);
+
+        // Append the boxes that come closer than radius to (x, y) to items, each one once
+        void QueryRadius(float x, float y, float radius, uint32_t layers, std::vector<int>& items);
+
+        // First box hit going from (x1, y1) to (x2, y2). Boxes containing the start are hit at fraction 0.
+        bool Raycast(float x1, float y1, float x2, float y2, uint32_t layers, int ignoredItem, RaycastHit& hit);
+
+        // Box closest to (x, y), closer than maxDistance, or -1 if there is none
+        int FindNearest(float x, float y, float maxDistance, uint32_t layers, int ignoredItem);
+};
+
+#endif
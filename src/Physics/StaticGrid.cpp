@@ -0,0 +1,136 @@
+#include "StaticGrid.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <cmath>
+
+// Widely scattered boxes would need a huge grid, so cells grow until there are at most this many per box
+const int MAX_CELLS_PER_BOX = 16;
+
+void StaticGrid::SetCellSize(float cellSize) {
+    if (!(cellSize > 0)) {
+        Logger::Err("Invalid static grid cell size " + std::to_string(cellSize) + ", keeping " + std::to_string(this->cellSize) + ".");
+        return;
+    }
+    this->cellSize = cellSize;
+}
+
+int StaticGrid::GetColumn(float x) const {
+    const float column = std::floor((x - originX) / gridCellSize);
+    return static_cast<int>(std::min(std::max(column, 0.0f), static_cast<float>(numColumns - 1)));
+}
+
+int StaticGrid::GetRow(float y) const {
+    const float row = std::floor((y - originY) / gridCellSize);
+    return static_cast<int>(std::min(std::max(row, 0.0f), static_cast<float>(numRows - 1)));
+}
+
+StaticGrid::CellRange StaticGrid::GetCellRange(const AABB& box) const {
+    return {GetColumn(box.minX), GetRow(box.minY), GetColumn(box.maxX), GetRow(box.maxY)};
+}
+
+void StaticGrid::Build(const std::vector<AABB>& boxes, const std::vector<CollisionFilter>& filters) {
+    this->boxes = boxes;
+    this->filters = filters;
+    cellRanges.clear();
+    cellItems.clear();
+    cellBoxes.Clear();
+
+    if (boxes.empty()) {
+        numColumns = numRows = 0;
+        cellStarts.assign(1, 0);
+        return;
+    }
+
+    float maxX = boxes[0].maxX;
+    float maxY = boxes[0].maxY;
+    originX = boxes[0].minX;
+    originY = boxes[0].minY;
+    for (const auto& box: boxes) {
+        originX = std::min(originX, box.minX);
+        originY = std::min(originY, box.minY);
+        maxX = std::max(maxX, box.maxX);
+        maxY = std::max(maxY, box.maxY);
+    }
+
+    gridCellSize = cellSize;
+    const double maxCells = static_cast<double>(boxes.size()) * MAX_CELLS_PER_BOX;
+    while ((std::floor((maxX - originX) / gridCellSize) + 1) * (std::floor((maxY - originY) / gridCellSize) + 1) > maxCells && std::isfinite(gridCellSize)) {
+        gridCellSize *= 2;
+    }
+    numColumns = static_cast<int>(std::floor((maxX - originX) / gridCellSize)) + 1;
+    numRows = static_cast<int>(std::floor((maxY - originY) / gridCellSize)) + 1;
+
+    // Count the boxes of each cell, turn the counts into start offsets, then fill the cells
+    cellStarts.assign(numColumns * numRows + 1, 0);
+    for (const auto& box: boxes) {
+        const CellRange range = GetCellRange(box);
+        cellRanges.push_back(range);
+        for (int row = range.minY; row <= range.maxY; row++) {
+            for (int column = range.minX; column <= range.maxX; column++) {
+                cellStarts[row * numColumns + column + 1]++;
+            }
+        }
+    }
+    for (size_t cell = 1; cell < cellStarts.size(); cell++) {
+        cellStarts[cell] += cellStarts[cell - 1];
+    }
+
+    cellEnds.assign(cellStarts.begin(), cellStarts.end() - 1);
+    cellItems.resize(cellStarts.back());
+    for (size_t i = 0; i < boxes.size(); i++) {
+        const CellRange& range = cellRanges[i];
+        for (int row = range.minY; row <= range.maxY; row++) {
+            for (int column = range.minX; column <= range.maxX; column++) {
+                cellItems[cellEnds[row * numColumns + column]++] = static_cast<int>(i);
+            }
+        }
+    }
+
+    cellBoxes.Reserve(cellItems.size());
+    for (int item: cellItems) {
+        cellBoxes.Add(boxes[item]);
+    }
+}
+
+size_t StaticGrid::GetSize() const {
+    return boxes.size();
+}
+
+const std::vector<AABB>& StaticGrid::GetBoxes() const {
+    return boxes;
+}
+
+// Size of the cells of the last build, which can be larger than requested
+float StaticGrid::GetCellSize() const {
+    return gridCellSize;
+}
+
+void StaticGrid::Query(const AABB& box, const CollisionFilter& filter, std::vector<int>& hits) {
+    if (boxes.empty() || filter.mask == 0 || filter.category == 0) {
+        return;
+    }
+
+    // Boxes outside the grid are clamped to its border cells, which still hold every static box they can touch
+    const CellRange range = GetCellRange(box);
+    for (int row = range.minY; row <= range.maxY; row++) {
+        for (int column = range.minX; column <= range.maxX; column++) {
+            const int cell = row * numColumns + column;
+
+            overlaps.clear();
+            cellBoxes.FindOverlaps(box, cellStarts[cell], cellStarts[cell + 1], overlaps);
+
+            for (int j: overlaps) {
+                const int item = cellItems[j];
+                if (!filter.CanCollideWith(filters[item])) {
+                    continue;
+                }
+
+                // A static box can share several cells with the query; only the first shared cell reports it
+                const CellRange& itemRange = cellRanges[item];
+                if (std::max(range.minX, itemRange.minX) == column && std::max(range.minY, itemRange.minY) == row) {
+                    hits.push_back(item);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef STATICGRID_H
+#define STATICGRID_H
+
+#include "AABB.h"
+#include "CollisionFilter.h"
+#include "AABBBatch.h"
+#include <vector>
+
+// === StaticGrid === //
+// Uniform grid over colliders that never move (obstacles, walls, trees). It is built once and
+// then only queried: every cell holds a contiguous run of its boxes, so a query runs the batch
+// overlap kernel over the few cells a moving box covers instead of re-binning the static boxes.
+// Rebuild it whenever the set of static boxes changes.
+
+class StaticGrid {
+    private:
+        struct CellRange {
+            int minX;
+            int minY;
+            int maxX;
+            int maxY;
+        };
+
+        float cellSize = 64;
+
+        // Grid covering every static box. Cells can be larger than requested, see Build()
+        float gridCellSize = 64;
+        float originX = 0;
+        float originY = 0;
+        int numColumns = 0;
+        int numRows = 0;
+
+        // Boxes as passed to Build(), with the cells each one covers
+        std::vector<AABB> boxes;
+        std::vector<CollisionFilter> filters;
+        std::vector<CellRange> cellRanges;
+
+        // Boxes of cell c are cellBoxes[cellStarts[c], cellStarts[c + 1]), cellItems holds their index in boxes
+        std::vector<int> cellStarts;
+        std::vector<int> cellItems;
+        std::vector<int> cellEnds;
+        AABBBatch cellBoxes;
+        std::vector<int> overlaps;
+
+        int GetColumn(float x) const;
+        int GetRow(float y) const;
+        CellRange GetCellRange(const AABB& box) const;
+
+    public:
+        StaticGrid() = default;
+
+        // Cells should be about the size of the typical box, e.g. one map tile. Takes effect on the next Build()
+        void SetCellSize(float cellSize);
+
+        void Build(const std::vector<AABB>& boxes, const std::vector<CollisionFilter>& filters);
+
+        size_t GetSize() const;
+        const std::vector<AABB>& GetBoxes() const;
+        float GetCellSize() const;
+
+        // Append to hits the index of every static box that overlaps box and whose filter
+        // accepts filter, each one once
+        void Query(const AABB& box, const CollisionFilter& filter, std::vector<int>& hits);
+};
+
+#endif
@@ -0,0 +1,83 @@
+#include "SweepAndPrune.h"
+#include <algorithm>
+
+const std::vector<std::pair<int, int>>& SweepAndPrune::FindOverlappingPairs(const std::vector<AABB>& boxes, const std::vector<CollisionFilter>& filters, const std::vector<int>& ids) {
+    queryCount++;
+    pairs.clear();
+
+    // Mark the boxes of this query and append the ones the list doesn't know yet
+    for (size_t i = 0; i < boxes.size(); i++) {
+        const int id = ids[i];
+        if (id >= static_cast<int>(lastSeenQuery.size())) {
+            lastSeenQuery.resize(id + 1, 0);
+            isInList.resize(id + 1, false);
+            boxPerId.resize(id + 1, -1);
+        }
+
+        lastSeenQuery[id] = queryCount;
+        boxPerId[id] = static_cast<int>(i);
+        if (!isInList[id]) {
+            isInList[id] = true;
+            endpoints.push_back({id, 0, boxes[i].minX, 0, filters[i]});
+        }
+    }
+
+    // Drop the boxes that are gone, keeping the order of the rest, and refresh the bounds
+    size_t numKept = 0;
+    for (size_t i = 0; i < endpoints.size(); i++) {
+        Endpoint endpoint = endpoints[i];
+        if (lastSeenQuery[endpoint.id] != queryCount) {
+            isInList[endpoint.id] = false;
+            continue;
+        }
+
+        endpoint.box = boxPerId[endpoint.id];
+        const AABB& box = boxes[endpoint.box];
+        endpoint.minX = box.minX;
+        endpoint.maxX = box.maxX;
+        endpoint.filter = filters[endpoint.box];
+        endpoints[numKept++] = endpoint;
+    }
+    endpoints.resize(numKept);
+
+    // The list was sorted last query, so only boxes that moved past a neighbour need shifting
+    for (size_t i = 1; i < endpoints.size(); i++) {
+        const Endpoint endpoint = endpoints[i];
+        size_t j = i;
+        while (j > 0 && endpoints[j - 1].minX > endpoint.minX) {
+            endpoints[j] = endpoints[j - 1];
+            j--;
+        }
+        endpoints[j] = endpoint;
+    }
+
+    sortedBoxes.Clear();
+    sortedBoxes.Reserve(endpoints.size());
+    for (const auto& endpoint: endpoints) {
+        sortedBoxes.Add(boxes[endpoint.box]);
+    }
+
+    // Sweep: every box after a in the list overlaps a on X until one starts past a's max X
+    for (size_t i = 0; i < endpoints.size(); i++) {
+        const Endpoint& a = endpoints[i];
+        size_t end = i + 1;
+        while (end < endpoints.size() && endpoints[end].minX < a.maxX) {
+            end++;
+        }
+
+        overlaps.clear();
+        sortedBoxes.FindOverlaps(boxes[a.box], i + 1, end, overlaps);
+
+        for (int j: overlaps) {
+            const Endpoint& b = endpoints[j];
+            if (a.filter.CanCollideWith(b.filter)) {
+                pairs.emplace_back(std::min(a.box, b.box), std::max(a.box, b.box));
+            }
+        }
+    }
+
+    // Report pairs in the same order as a plain nested loop over the boxes would
+    std::sort(pairs.begin(), pairs.end());
+
+    return pairs;
+}
@@ -0,0 +1,48 @@
+#ifndef SWEEPANDPRUNE_H
+#define SWEEPANDPRUNE_H
+
+#include "AABB.h"
+#include "CollisionFilter.h"
+#include "AABBBatch.h"
+#include <vector>
+#include <utility>
+
+// === SweepAndPrune === //
+// Broad phase that keeps the boxes sorted by their min X across frames. Most boxes only move
+// a little between frames, so an insertion sort puts the list back in order in close to linear time.
+// Sweeping the list yields the runs of boxes whose X intervals overlap, which go through the batch overlap kernel.
+
+class SweepAndPrune {
+    private:
+        struct Endpoint {
+            int id;
+            int box;
+            float minX;
+            float maxX;
+            CollisionFilter filter;
+        };
+
+        // Persistent list, sorted by minX, and a copy of its boxes for the kernel
+        std::vector<Endpoint> endpoints;
+        AABBBatch sortedBoxes;
+        std::vector<int> overlaps;
+
+        // Bookkeeping per id: last query the id was seen in, and whether it is in the list
+        // Vector index = id
+        std::vector<int> lastSeenQuery;
+        std::vector<bool> isInList;
+        std::vector<int> boxPerId;
+        int queryCount = 0;
+
+        std::vector<std::pair<int, int>> pairs;
+
+    public:
+        SweepAndPrune() = default;
+
+        // ids[i] is a stable, non-negative identifier of boxes[i] (e.g. the entity id) used to track
+        // the box between queries. Returns the pairs (i, j) with i < j whose boxes overlap and whose
+        // filters accept each other, sorted.
+        const std::vector<std::pair<int, int>>& FindOverlappingPairs(const std::vector<AABB>& boxes, const std::vector<CollisionFilter>& filters, const std::vector<int>& ids);
+};
+
+#endif
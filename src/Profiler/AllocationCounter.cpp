@@ -0,0 +1,38 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+std::atomic<long> AllocationCounter::totalAllocations(0);
+long AllocationCounter::frameStartAllocations = 0;
+long AllocationCounter::lastFrameAllocations = 0;
+
+void AllocationCounter::NewFrame() {
+    long total = GetTotalAllocations();
+    lastFrameAllocations = total - frameStartAllocations;
+    frameStartAllocations = total;
+}
+
+long AllocationCounter::GetTotalAllocations() {
+    return totalAllocations.load(std::memory_order_relaxed);
+}
+
+long AllocationCounter::GetLastFrameAllocations() {
+    return lastFrameAllocations;
+}
+
+// Replace the global allocation functions so every new/delete goes through the counter
+void* operator new(std::size_t size) {
+    AllocationCounter::Increment();
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
@@ -0,0 +1,25 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <atomic>
+
+// Counts heap allocations made through the global operator new,
+// so we can check how many allocations a frame of the game loop costs.
+
+class AllocationCounter {
+    private:
+        static std::atomic<long> totalAllocations;
+        static long frameStartAllocations;
+        static long lastFrameAllocations;
+
+    public:
+        static void Increment() {
+            totalAllocations.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        static void NewFrame();
+        static long GetTotalAllocations();
+        static long GetLastFrameAllocations();
+};
+
+#endif
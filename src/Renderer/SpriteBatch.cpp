@@ -0,0 +1,146 @@
+#include "SpriteBatch.h"
+#include "../Logger/Logger.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <string>
+
+void SpriteBatch::Begin() {
+    sprites.clear();
+}
+
+void SpriteBatch::Add(const SpriteDraw& sprite) {
+    // A missing texture can't be copied; as geometry it would come out as a white box
+    if (!sprite.texture) {
+        return;
+    }
+    sprites.push_back(sprite);
+}
+
+void SpriteBatch::End(SDL_Renderer* renderer) {
+    numDrawCalls = 0;
+    numDrawnSprites = static_cast<int>(sprites.size());
+
+    std::sort(sprites.begin(), sprites.end(), [](const SpriteDraw& a, const SpriteDraw& b) {
+        if (a.zIndex != b.zIndex) {
+            return a.zIndex < b.zIndex;
+        }
+        return std::less<SDL_Texture*>()(a.texture, b.texture);
+    });
+
+    if (!isBatched) {
+        DrawEach(renderer, 0, sprites.size());
+        return;
+    }
+
+    size_t begin = 0;
+    while (begin < sprites.size()) {
+        size_t end = begin + 1;
+        while (end < sprites.size() && sprites[end].texture == sprites[begin].texture) {
+            end++;
+        }
+
+        // A failed batch turns batching off, so the remaining runs are drawn one by one too
+        if (!isBatched || !DrawBatch(renderer, begin, end)) {
+            DrawEach(renderer, begin, end);
+        }
+        begin = end;
+    }
+}
+
+void SpriteBatch::DrawEach(SDL_Renderer* renderer, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        const SpriteDraw& sprite = sprites[i];
+        SDL_RenderCopyEx(renderer, sprite.texture, &sprite.srcRect, &sprite.dstRect, sprite.rotation, NULL, sprite.flip);
+    }
+    numDrawCalls += static_cast<int>(end - begin);
+}
+
+bool SpriteBatch::DrawBatch(SDL_Renderer* renderer, size_t begin, size_t end) {
+#if SPRITEBATCH_HAS_GEOMETRY
+    SDL_Texture* texture = sprites[begin].texture;
+    int textureWidth = 0;
+    int textureHeight = 0;
+    if (SDL_QueryTexture(texture, NULL, NULL, &textureWidth, &textureHeight) != 0 || textureWidth == 0 || textureHeight == 0) {
+        return false;
+    }
+
+    vertices.clear();
+    indices.clear();
+
+    const SDL_Color white = {255, 255, 255, 255};
+    for (size_t i = begin; i < end; i++) {
+        const SpriteDraw& sprite = sprites[i];
+
+        float u0 = static_cast<float>(sprite.srcRect.x) / textureWidth;
+        float v0 = static_cast<float>(sprite.srcRect.y) / textureHeight;
+        float u1 = static_cast<float>(sprite.srcRect.x + sprite.srcRect.w) / textureWidth;
+        float v1 = static_cast<float>(sprite.srcRect.y + sprite.srcRect.h) / textureHeight;
+        if (sprite.flip & SDL_FLIP_HORIZONTAL) {
+            std::swap(u0, u1);
+        }
+        if (sprite.flip & SDL_FLIP_VERTICAL) {
+            std::swap(v0, v1);
+        }
+
+        // Corners relative to the center, clockwise from the top left, like SDL_RenderCopyEx rotates
+        const float halfWidth = sprite.dstRect.w * 0.5f;
+        const float halfHeight = sprite.dstRect.h * 0.5f;
+        const float centerX = sprite.dstRect.x + halfWidth;
+        const float centerY = sprite.dstRect.y + halfHeight;
+        SDL_FPoint corners[4] = {
+            {-halfWidth, -halfHeight},
+            {halfWidth, -halfHeight},
+            {halfWidth, halfHeight},
+            {-halfWidth, halfHeight}
+        };
+        if (sprite.rotation != 0.0) {
+            const double radians = glm::radians(sprite.rotation);
+            const float cosine = static_cast<float>(std::cos(radians));
+            const float sine = static_cast<float>(std::sin(radians));
+            for (auto& corner: corners) {
+                corner = {corner.x * cosine - corner.y * sine, corner.x * sine + corner.y * cosine};
+            }
+        }
+
+        const int firstVertex = static_cast<int>(vertices.size());
+        vertices.push_back({{centerX + corners[0].x, centerY + corners[0].y}, white, {u0, v0}});
+        vertices.push_back({{centerX + corners[1].x, centerY + corners[1].y}, white, {u1, v0}});
+        vertices.push_back({{centerX + corners[2].x, centerY + corners[2].y}, white, {u1, v1}});
+        vertices.push_back({{centerX + corners[3].x, centerY + corners[3].y}, white, {u0, v1}});
+        for (int index: {0, 1, 2, 2, 3, 0}) {
+            indices.push_back(firstVertex + index);
+        }
+    }
+
+    if (SDL_RenderGeometry(renderer, texture, vertices.data(), static_cast<int>(vertices.size()), indices.data(), static_cast<int>(indices.size())) != 0) {
+        Logger::Err("Sprite batching is not supported by this renderer, drawing sprites one by one: " + std::string(SDL_GetError()));
+        isBatched = false;
+        return false;
+    }
+    numDrawCalls++;
+    return true;
+#else
+    (void)renderer;
+    (void)begin;
+    (void)end;
+    return false;
+#endif
+}
+
+void SpriteBatch::SetBatched(bool isBatched) {
+    this->isBatched = isBatched && SPRITEBATCH_HAS_GEOMETRY;
+}
+
+bool SpriteBatch::IsBatched() const {
+    return isBatched;
+}
+
+int SpriteBatch::GetNumDrawCalls() const {
+    return numDrawCalls;
+}
+
+int SpriteBatch::GetNumDrawnSprites() const {
+    return numDrawnSprites;
+}
@@ -0,0 +1,63 @@
+#ifndef SPRITEBATCH_H
+#define SPRITEBATCH_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <vector>
+
+// SDL_RenderGeometry appeared in SDL 2.0.18; older versions always draw one sprite at a time
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define SPRITEBATCH_HAS_GEOMETRY 1
+#else
+#define SPRITEBATCH_HAS_GEOMETRY 0
+#endif
+
+// A textured rectangle to draw, in screen coordinates, rotated in degrees clockwise around its center
+struct SpriteDraw {
+    SDL_Texture* texture;
+    SDL_Rect srcRect;
+    SDL_Rect dstRect;
+    double rotation;
+    SDL_RendererFlip flip;
+    int zIndex;
+};
+
+// === SpriteBatch === //
+// Collects a frame's sprites and draws them back to front. Sprites are sorted by (zIndex, texture),
+// so every run of consecutive sprites sharing a texture becomes one SDL_RenderGeometry call of two triangles
+// per sprite, with rotation and flip applied to the vertices on the CPU. Without batching (turned
+// off, SDL too old, or a renderer without geometry support) each sprite is an SDL_RenderCopyEx call.
+
+class SpriteBatch {
+    private:
+        std::vector<SpriteDraw> sprites;
+#if SPRITEBATCH_HAS_GEOMETRY
+        std::vector<SDL_Vertex> vertices;
+        std::vector<int> indices;
+#endif
+
+        bool isBatched = SPRITEBATCH_HAS_GEOMETRY;
+        int numDrawCalls = 0;
+        int numDrawnSprites = 0;
+
+        void DrawEach(SDL_Renderer* renderer, size_t begin, size_t end);
+        bool DrawBatch(SDL_Renderer* renderer, size_t begin, size_t end);
+
+    public:
+        SpriteBatch() = default;
+
+        // Forgets the sprites of the previous frame; the buffers keep their capacity
+        void Begin();
+        void Add(const SpriteDraw& sprite);
+        void End(SDL_Renderer* renderer);
+
+        // Batching can only be turned on when SDL supports it
+        void SetBatched(bool isBatched);
+        bool IsBatched() const;
+
+        // Of the last End()
+        int GetNumDrawCalls() const;
+        int GetNumDrawnSprites() const;
+};
+
+#endif
@@ -0,0 +1,82 @@
+#include "SystemScheduler.h"
+#include "../Logger/Logger.h"
+#include <chrono>
+
+SystemScheduler::SystemScheduler(ThreadPool& threadPool): threadPool(threadPool) {
+    Logger::Log("SystemScheduler constructor called.");
+}
+
+SystemScheduler::~SystemScheduler() {
+    Logger::Log("SystemScheduler destructor called.");
+}
+
+void SystemScheduler::AddSystem(const std::string& name, const System& system, std::function<void(double)> update) {
+    scheduledSystems.push_back({name, &system, update, 0});
+    timings.push_back({name, 0, 0.0});
+    BuildWaves();
+}
+
+void SystemScheduler::BuildWaves() {
+    // A system runs one wave after the latest earlier system it conflicts with
+    waves.clear();
+    for (size_t i = 0; i < scheduledSystems.size(); i++) {
+        int wave = 0;
+        for (size_t j = 0; j < i; j++) {
+            if (scheduledSystems[i].system->ConflictsWith(*scheduledSystems[j].system)) {
+                wave = std::max(wave, scheduledSystems[j].wave + 1);
+            }
+        }
+        scheduledSystems[i].wave = wave;
+        timings[i].wave = wave;
+
+        if (wave >= static_cast<int>(waves.size())) {
+            waves.resize(wave + 1);
+        }
+        waves[wave].push_back(i);
+    }
+}
+
+void SystemScheduler::RunSystem(int index, double deltaTime) {
+    auto start = std::chrono::steady_clock::now();
+    scheduledSystems[index].update(deltaTime);
+    auto end = std::chrono::steady_clock::now();
+    timings[index].milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void SystemScheduler::Run(double deltaTime) {
+    if (isDeterministic) {
+        for (size_t i = 0; i < scheduledSystems.size(); i++) {
+            RunSystem(i, deltaTime);
+        }
+        return;
+    }
+
+    std::vector<std::function<void()>> tasks;
+    for (const auto& wave: waves) {
+        if (wave.size() == 1) {
+            RunSystem(wave[0], deltaTime);
+            continue;
+        }
+
+        tasks.clear();
+        for (auto index: wave) {
+            tasks.push_back([this, index, deltaTime]() {
+                RunSystem(index, deltaTime);
+            });
+        }
+        threadPool.Run(tasks);
+    }
+}
+
+void SystemScheduler::SetDeterministic(bool isDeterministic) {
+    this->isDeterministic = isDeterministic;
+    threadPool.SetSerial(isDeterministic);
+}
+
+bool SystemScheduler::IsDeterministic() const {
+    return isDeterministic;
+}
+
+const std::vector<SystemTiming>& SystemScheduler::GetTimings() const {
+    return timings;
+}
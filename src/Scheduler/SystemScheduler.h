@@ -0,0 +1,56 @@
+#ifndef SYSTEMSCHEDULER_H
+#define SYSTEMSCHEDULER_H
+
+#include "../ECS/ECS.h"
+#include "ThreadPool.h"
+#include <string>
+#include <vector>
+#include <functional>
+
+struct SystemTiming {
+    std::string name;
+    int wave;
+    double milliseconds;
+};
+
+// === SystemScheduler === //
+// Runs system updates in waves. Systems whose component access doesn't conflict share a wave
+// and run concurrently on the thread pool; conflicting systems keep the order they were added in.
+
+class SystemScheduler {
+    private:
+        struct ScheduledSystem {
+            std::string name;
+            const System* system;
+            std::function<void(double)> update;
+            int wave;
+        };
+
+        ThreadPool& threadPool;
+        std::vector<ScheduledSystem> scheduledSystems;
+        std::vector<std::vector<int>> waves;
+        std::vector<SystemTiming> timings;
+        bool isDeterministic = false;
+
+        void BuildWaves();
+        void RunSystem(int index, double deltaTime);
+
+    public:
+        SystemScheduler(ThreadPool& threadPool);
+        ~SystemScheduler();
+
+        // Systems must be added in the order they would run sequentially
+        void AddSystem(const std::string& name, const System& system, std::function<void(double)> update);
+
+        void Run(double deltaTime);
+
+        // In deterministic mode every system runs on the calling thread in the order it was added,
+        // and so do the chunks of the ParallelForEach loops inside them
+        void SetDeterministic(bool isDeterministic);
+        bool IsDeterministic() const;
+
+        // Duration of every system during the last Run()
+        const std::vector<SystemTiming>& GetTimings() const;
+};
+
+#endif
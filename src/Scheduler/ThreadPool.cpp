@@ -0,0 +1,166 @@
+#include "ThreadPool.h"
+#include "../Logger/Logger.h"
+
+#include <algorithm>
+
+namespace {
+    // Queue owned by the current thread, -1 for threads outside the pool
+    thread_local int workerQueueIndex = -1;
+    thread_local const ThreadPool* workerPool = nullptr;
+}
+
+ThreadPool::ThreadPool(int numWorkers): isRunning(true), isSerial(false), numQueuedTasks(0), nextQueue(0) {
+    if (numWorkers < 0) {
+        numWorkers = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+        numWorkers = numWorkers < 0 ? 0 : numWorkers;
+    }
+
+    for (int i = 0; i < numWorkers + 1; i++) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    for (int i = 0; i < numWorkers; i++) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+
+    Logger::Log("ThreadPool constructor called with " + std::to_string(numWorkers) + " workers.");
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        isRunning = false;
+    }
+    wakeCondition.notify_all();
+
+    for (auto& worker: workers) {
+        worker.join();
+    }
+
+    Logger::Log("ThreadPool destructor called.");
+}
+
+int ThreadPool::GetNumThreads() const {
+    return static_cast<int>(workers.size()) + 1;
+}
+
+size_t ThreadPool::GetChunkSize(size_t count) const {
+    const size_t CHUNK_ALIGNMENT = 64;
+    const size_t CHUNKS_PER_THREAD = 4;
+
+    size_t chunkSize = count / (GetNumThreads() * CHUNKS_PER_THREAD);
+    chunkSize = (chunkSize + CHUNK_ALIGNMENT - 1) / CHUNK_ALIGNMENT * CHUNK_ALIGNMENT;
+    return std::max(chunkSize, CHUNK_ALIGNMENT);
+}
+
+int ThreadPool::GetCurrentQueueIndex() const {
+    if (workerPool == this) {
+        return workerQueueIndex;
+    }
+    return static_cast<int>(queues.size()) - 1;
+}
+
+void ThreadPool::PushTask(int queueIndex, std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(queues[queueIndex]->mutex);
+        queues[queueIndex]->tasks.push_back(std::move(task));
+    }
+    numQueuedTasks++;
+}
+
+bool ThreadPool::PopTask(int queueIndex, std::function<void()>& task) {
+    // Newest task from our own queue first, it is the most likely to be warm in cache
+    {
+        auto& queue = *queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            numQueuedTasks--;
+            return true;
+        }
+    }
+
+    // Otherwise steal the oldest task of another queue
+    const int numQueues = static_cast<int>(queues.size());
+    for (int offset = 1; offset < numQueues; offset++) {
+        auto& queue = *queues[(queueIndex + offset) % numQueues];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            numQueuedTasks--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::WorkerLoop(int queueIndex) {
+    workerQueueIndex = queueIndex;
+    workerPool = this;
+
+    std::function<void()> task;
+    while (true) {
+        if (PopTask(queueIndex, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeCondition.wait(lock, [this]() {
+            return !isRunning || numQueuedTasks > 0;
+        });
+        if (!isRunning) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::Run(const std::vector<std::function<void()>>& tasks) {
+    if (tasks.empty()) {
+        return;
+    }
+
+    if (isSerial) {
+        for (const auto& task: tasks) {
+            task();
+        }
+        return;
+    }
+
+    std::atomic<int> numRemainingTasks(static_cast<int>(tasks.size()));
+
+    // Spread the tasks over all the queues, workers will balance the rest by stealing
+    for (const auto& task: tasks) {
+        const int queueIndex = nextQueue++ % queues.size();
+        PushTask(queueIndex, [&task, &numRemainingTasks]() {
+            task();
+            numRemainingTasks--;
+        });
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeCondition.notify_all();
+
+    // Help out until our batch is done
+    const int queueIndex = GetCurrentQueueIndex();
+    std::function<void()> task;
+    while (numRemainingTasks > 0) {
+        if (PopTask(queueIndex, task)) {
+            task();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void ThreadPool::SetSerial(bool isSerial) {
+    this->isSerial = isSerial;
+}
+
+bool ThreadPool::IsSerial() const {
+    return isSerial;
+}
@@ -0,0 +1,64 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+// === ThreadPool === //
+// A fixed set of worker threads with one task deque each.
+// Workers pop from the back of their own deque and steal from the front of the others when they run dry.
+
+class ThreadPool {
+    private:
+        struct WorkerQueue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::thread> workers;
+
+        // One queue per worker, plus a last one shared by threads outside the pool
+        std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+        std::atomic<bool> isRunning;
+        std::atomic<bool> isSerial;
+        std::atomic<int> numQueuedTasks;
+        std::atomic<unsigned int> nextQueue;
+
+        std::mutex sleepMutex;
+        std::condition_variable wakeCondition;
+
+        int GetCurrentQueueIndex() const;
+        void PushTask(int queueIndex, std::function<void()> task);
+        bool PopTask(int queueIndex, std::function<void()>& task);
+        void WorkerLoop(int queueIndex);
+
+    public:
+        // By default use one worker per hardware thread, minus the thread calling Run()
+        ThreadPool(int numWorkers = -1);
+        ~ThreadPool();
+
+        // Number of threads that execute tasks, including the calling thread
+        int GetNumThreads() const;
+
+        // Number of items per task when splitting count items for a data-parallel loop.
+        // A few chunks per thread leave room for stealing; sizes are a multiple of 64 items
+        // so neighbouring chunks share at most one cache line.
+        size_t GetChunkSize(size_t count) const;
+
+        // Execute all the tasks and return once every one of them finished.
+        // The calling thread runs tasks too, so Run() can be nested inside a task.
+        void Run(const std::vector<std::function<void()>>& tasks);
+
+        // In serial mode Run() executes the tasks on the calling thread, one after the other in order
+        void SetSerial(bool isSerial);
+        bool IsSerial() const;
+};
+
+#endif
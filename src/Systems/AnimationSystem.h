@@ -12,16 +12,13 @@ class AnimationSystem: public System {
             RequireComponent<AnimationComponent>();
         }
 
-        void Update() {
-            for (auto entity: GetSystemEntities()) {
-                auto& animation = entity.GetComponent<AnimationComponent>();
-                auto& sprite = entity.GetComponent<SpriteComponent>();
-
+        void Update(const std::unique_ptr<Registry>& registry, ThreadPool& threadPool) {
+            registry->GetView<AnimationComponent, SpriteComponent>().ParallelForEach(threadPool, [](Entity entity, AnimationComponent& animation, SpriteComponent& sprite) {
                 animation.currentFrame = ((SDL_GetTicks() - animation.startTime) 
                     * animation.frameSpeedRate / 1000) % animation.numFrames;
 
                 sprite.srcRect.x = animation.currentFrame * sprite.width;
-            }
+            });
         }
 };
 
@@ -3,62 +3,285 @@
 
 #include "../ECS/ECS.h"
 #include "../EventBus/EventBus.h"
-#include "../Events/CollisionEvent.h"
+#include "../Events/CollisionEnterEvent.h"
+#include "../Events/CollisionStayEvent.h"
+#include "../Events/CollisionExitEvent.h"
 #include "../Components/BoxColliderComponent.h"
 #include "../Components/TransformComponent.h"
+#include "../Components/RigidBodyComponent.h"
+#include "../Physics/AABB.h"
+#include "../Physics/SpatialHash.h"
+#include "../Physics/SweepAndPrune.h"
+#include "../Physics/StaticGrid.h"
+#include "../Physics/ContactTracker.h"
+
+// Algorithm used to find the overlapping collider pairs
+enum BroadPhase {
+    BROADPHASE_SPATIAL_HASH,
+    BROADPHASE_SWEEP_AND_PRUNE
+};
 
 class CollisionSystem : public System {
+    private:
+        // Reused between frames so gathering colliders doesn't allocate
+        std::vector<Entity> colliders;
+        std::vector<AABB> boxes;
+        std::vector<AABB> sweptBoxes;
+        std::vector<glm::vec2> displacements;
+        std::vector<bool> isFast;
+        std::vector<CollisionFilter> filters;
+        std::vector<int> entityIds;
+
+        // Static colliders go into a grid that is only rebuilt when they change,
+        // so per frame only dynamic colliders are binned and queried against it
+        std::vector<Entity> staticColliders;
+        std::vector<AABB> staticBoxes;
+        std::vector<CollisionFilter> staticFilters;
+        // Slot of each static collider in the vectors above, or -1. Vector index = entity id
+        std::vector<int> staticIndexPerId;
+        StaticGrid staticGrid;
+        std::vector<int> staticHits;
+        bool isStaticGridDirty = true;
+        int numStaticRebuilds = 0;
+
+        BroadPhase broadPhase = BROADPHASE_SPATIAL_HASH;
+        SpatialHash spatialHash;
+        SweepAndPrune sweepAndPrune;
+        int numOverlappingPairs = 0;
+        int numSweptColliders = 0;
+
+        // Overlapping pairs from previous frames, so events fire when a contact starts and ends
+        ContactTracker contactTracker;
+        bool isStayEventEnabled = false;
+
+        // Entity id and generation packed in one key, so a recycled id never continues an old contact
+        static uint64_t GetContactKey(Entity entity) {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(entity.GetGeneration())) << 32) | static_cast<uint32_t>(entity.GetId());
+        }
+
+        static Entity GetContactEntity(uint64_t key, Registry* registry) {
+            Entity entity(static_cast<int>(key & 0xFFFFFFFF), static_cast<int>(key >> 32));
+            entity.registry = registry;
+            return entity;
+        }
+
+        static AABB GetBox(const TransformComponent& transform, const BoxColliderComponent& collider) {
+            const float x = transform.position.x + collider.offset.x;
+            const float y = transform.position.y + collider.offset.y;
+            return AABB(x, y, x + collider.width, y + collider.height);
+        }
+
+        static bool IsStatic(Entity entity, const BoxColliderComponent& collider) {
+            return collider.isStatic || !entity.HasComponent<RigidBodyComponent>();
+        }
+
+        // Whether the grid holds this entity with this box, looked up by id so the pool's order doesn't matter
+        bool IsInStaticGrid(Entity entity, const AABB& box, const CollisionFilter& filter) const {
+            const int entityId = entity.GetId();
+            if (entityId >= static_cast<int>(staticIndexPerId.size()) || staticIndexPerId[entityId] == -1) {
+                return false;
+            }
+            const int index = staticIndexPerId[entityId];
+            const AABB& builtBox = staticBoxes[index];
+            return staticColliders[index] == entity &&
+                builtBox.minX == box.minX && builtBox.minY == box.minY && builtBox.maxX == box.maxX && builtBox.maxY == box.maxY &&
+                staticFilters[index].category == filter.category && staticFilters[index].mask == filter.mask;
+        }
+
+        void RebuildStaticGrid(const std::unique_ptr<Registry>& registry) {
+            for (auto entity: staticColliders) {
+                staticIndexPerId[entity.GetId()] = -1;
+            }
+            staticColliders.clear();
+            staticBoxes.clear();
+            staticFilters.clear();
+            registry->GetView<TransformComponent, BoxColliderComponent>().Each([&](Entity entity, const TransformComponent& transform, const BoxColliderComponent& collider) {
+                if (!IsStatic(entity, collider)) {
+                    return;
+                }
+                if (entity.GetId() >= static_cast<int>(staticIndexPerId.size())) {
+                    staticIndexPerId.resize(entity.GetId() + 1, -1);
+                }
+                staticIndexPerId[entity.GetId()] = static_cast<int>(staticColliders.size());
+                staticColliders.push_back(entity);
+                staticBoxes.push_back(GetBox(transform, collider));
+                staticFilters.push_back(collider.filter);
+            });
+
+            staticGrid.Build(staticBoxes, staticFilters);
+            isStaticGridDirty = false;
+            numStaticRebuilds++;
+        }
+
+        const std::vector<std::pair<int, int>>& FindOverlappingPairs() {
+            if (broadPhase == BROADPHASE_SWEEP_AND_PRUNE) {
+                return sweepAndPrune.FindOverlappingPairs(sweptBoxes, filters, entityIds);
+            }
+            return spatialHash.FindOverlappingPairs(sweptBoxes, filters);
+        }
+
+        // Pairs with a fast collider only overlap in the broad phase over the whole move,
+        // so check they actually meet at the same time during the frame
+        static bool IsSweptTouching(const AABB& aBox, glm::vec2 aDisplacement, const AABB& bBox, glm::vec2 bDisplacement) {
+            const glm::vec2 relativeDisplacement = aDisplacement - bDisplacement;
+            const AABB aStart(aBox.minX - aDisplacement.x, aBox.minY - aDisplacement.y, aBox.maxX - aDisplacement.x, aBox.maxY - aDisplacement.y);
+            const AABB bStart(bBox.minX - bDisplacement.x, bBox.minY - bDisplacement.y, bBox.maxX - bDisplacement.x, bBox.maxY - bDisplacement.y);
+
+            float timeOfImpact;
+            return aStart.Sweep(relativeDisplacement.x, relativeDisplacement.y, bStart, timeOfImpact);
+        }
+
+        void EmitContact(std::unique_ptr<EventBus>& eventBus, Entity a, Entity b) {
+            if (contactTracker.Touch(GetContactKey(a), GetContactKey(b))) {
+                Logger::Log("Entity " + std::to_string(a.GetId()) + " started colliding with Entity " + std::to_string(b.GetId()));
+
+                eventBus->QueueEvent<CollisionEnterEvent>(a, b);
+            } else if (isStayEventEnabled) {
+                eventBus->QueueEvent<CollisionStayEvent>(a, b);
+            }
+        }
+
     public:
         CollisionSystem() {
-            RequireComponent<BoxColliderComponent>();
-            RequireComponent<TransformComponent>();
+            RequireComponent<BoxColliderComponent>(ACCESS_READ);
+            RequireComponent<TransformComponent>(ACCESS_READ);
+
+            // Velocities of fast colliders; collision events are only queued here, and handled after all systems ran
+            ReadsComponent<RigidBodyComponent>();
         }
 
-        void Update(std::unique_ptr<EventBus>& eventBus) {
-            auto entities = GetSystemEntities();
-            
-            for (auto i = entities.begin(); i != entities.end(); i++) {
-                Entity a = *i;
-                auto aTransform = a.GetComponent<TransformComponent>();
-                auto aCollider = a.GetComponent<BoxColliderComponent>();
+        // Use about one map tile per cell
+        void SetCellSize(float cellSize) {
+            spatialHash.SetCellSize(cellSize);
+            staticGrid.SetCellSize(cellSize);
+            isStaticGridDirty = true;
+        }
 
-                for (auto j = i; j != entities.end(); j++) {
-                    Entity b = *j;
+        // Can be switched at any time, e.g. from the debug GUI to compare both
+        void SetBroadPhase(BroadPhase broadPhase) {
+            this->broadPhase = broadPhase;
+        }
 
-                    if (a == b) {
-                        continue;
-                    }
+        BroadPhase GetBroadPhase() const {
+            return broadPhase;
+        }
+
+        int GetNumOverlappingPairs() const {
+            return numOverlappingPairs;
+        }
+
+        int GetNumStaticColliders() const {
+            return static_cast<int>(staticColliders.size());
+        }
+
+        int GetNumDynamicColliders() const {
+            return static_cast<int>(colliders.size());
+        }
+
+        // How often the static grid had to be rebuilt; it should stay flat while nothing static changes
+        int GetNumStaticRebuilds() const {
+            return numStaticRebuilds;
+        }
+
+        int GetNumSweptColliders() const {
+            return numSweptColliders;
+        }
+
+        int GetNumContacts() const {
+            return static_cast<int>(contactTracker.GetNumContacts());
+        }
 
-                    auto bTransform = b.GetComponent<TransformComponent>();
-                    auto bCollider = b.GetComponent<BoxColliderComponent>();
+        // Stay events fire on every frame of every contact, so they are off unless someone needs them
+        void SetStayEventEnabled(bool isStayEventEnabled) {
+            this->isStayEventEnabled = isStayEventEnabled;
+        }
+
+        bool IsStayEventEnabled() const {
+            return isStayEventEnabled;
+        }
 
-                    bool collisionHappened = CheckAABBCollision(
-                        aTransform.position.x + aCollider.offset.x,
-                        aTransform.position.y + aCollider.offset.y,
-                        aCollider.width,
-                        aCollider.height,
-                        bTransform.position.x + bCollider.offset.x,
-                        bTransform.position.y + bCollider.offset.y,
-                        bCollider.width,
-                        bCollider.height
-                    );
+        void Update(double deltaTime, std::unique_ptr<EventBus>& eventBus, const std::unique_ptr<Registry>& registry) {
+            colliders.clear();
+            boxes.clear();
+            sweptBoxes.clear();
+            displacements.clear();
+            isFast.clear();
+            filters.clear();
+            entityIds.clear();
+            numSweptColliders = 0;
+            // Static colliders are only checked against the grid; one that was added, moved
+            // or has a new filter is missing from it, and one that was removed lowers the count
+            size_t numStatic = 0;
+            bool isStaticChanged = false;
+            registry->GetView<TransformComponent, BoxColliderComponent>().Each([&](Entity entity, const TransformComponent& transform, const BoxColliderComponent& collider) {
+                const AABB box = GetBox(transform, collider);
+
+                if (IsStatic(entity, collider)) {
+                    numStatic++;
+                    isStaticChanged = isStaticChanged || !IsInStaticGrid(entity, box, collider.filter);
+                    return;
+                }
 
-                    if (collisionHappened) {
-                        Logger::Log("Entity " + std::to_string(a.GetId()) + " is colliding with Entity " + std::to_string(b.GetId()));
+                colliders.push_back(entity);
+                boxes.push_back(box);
+                filters.push_back(collider.filter);
+                entityIds.push_back(entity.GetId());
+
+                // The movement system already moved the entity by its velocity this frame,
+                // so a fast collider covers everything from where it was to where it is now
+                glm::vec2 displacement(0);
+                if (collider.isFast) {
+                    displacement = entity.GetComponent<RigidBodyComponent>().velocity * static_cast<float>(deltaTime);
+                    numSweptColliders++;
+                }
+                displacements.push_back(displacement);
+                isFast.push_back(collider.isFast);
+                sweptBoxes.emplace_back(
+                    std::min(box.minX, box.minX - displacement.x),
+                    std::min(box.minY, box.minY - displacement.y),
+                    std::max(box.maxX, box.maxX - displacement.x),
+                    std::max(box.maxY, box.maxY - displacement.y)
+                );
+            });
+
+            // Dynamic colliders coming and going, or reordering the pools, leave the grid alone
+            if (isStaticGridDirty || isStaticChanged || numStatic != staticColliders.size()) {
+                RebuildStaticGrid(registry);
+            }
 
-                        eventBus->EmitEvent<CollisionEvent>(a, b);
+            // Broad phase: only nearby dynamic colliders whose layers interact are tested against each other,
+            // a batch at a time with the SIMD overlap kernel. Fast colliders take part with their swept box.
+            const auto& overlappingPairs = FindOverlappingPairs();
+            numOverlappingPairs = static_cast<int>(overlappingPairs.size());
+
+            contactTracker.BeginFrame();
+            for (const auto& pair: overlappingPairs) {
+                const int a = pair.first;
+                const int b = pair.second;
+                if ((isFast[a] || isFast[b]) && !IsSweptTouching(boxes[a], displacements[a], boxes[b], displacements[b])) {
+                    continue;
+                }
+                EmitContact(eventBus, colliders[a], colliders[b]);
+            }
+
+            // Each dynamic collider against the static grid. Static pairs never change, so they are never queried.
+            for (size_t i = 0; i < colliders.size(); i++) {
+                staticHits.clear();
+                staticGrid.Query(sweptBoxes[i], filters[i], staticHits);
+                numOverlappingPairs += static_cast<int>(staticHits.size());
+
+                for (int j: staticHits) {
+                    if (isFast[i] && !IsSweptTouching(boxes[i], displacements[i], staticBoxes[j], glm::vec2(0))) {
+                        continue;
                     }
+                    EmitContact(eventBus, colliders[i], staticColliders[j]);
                 }
             }
-        }
 
-        bool CheckAABBCollision(double aX, double aY, double aW, double aH, double bX, double bY, double bW, double bH) {
-            return (
-                aX < bX + bW &&
-                aX + aW > bX &&
-                aY < bY + bH &&
-                aY + aH > bY
-            );
+            // Contacts nobody touched this frame have separated, or one of their entities is gone
+            for (const auto& contact: contactTracker.EndFrame()) {
+                eventBus->QueueEvent<CollisionExitEvent>(GetContactEntity(contact.a, registry.get()), GetContactEntity(contact.b, registry.get()));
+            }
         }
 };
 
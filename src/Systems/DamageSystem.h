@@ -6,37 +6,45 @@
 #include "../Components/ProjectileComponent.h"
 #include "../Components/HealthComponent.h"
 #include "../EventBus/EventBus.h"
-#include "../Events/CollisionEvent.h"
+#include "../Events/CollisionEnterEvent.h"
 
 class DamageSystem: public System {
+    private:
+        EventSubscriptions subscriptions;
+
     public:
         DamageSystem() {
             RequireComponent<BoxColliderComponent>();
         }
 
-        void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus) {
-            eventBus->SubscribeToEvent<CollisionEvent>(this, &DamageSystem::onCollision);
+        void SubscribeToEvents(const std::unique_ptr<EventBus>& eventBus) {
+            subscriptions.UnsubscribeAll();
+            eventBus->SubscribeToEvent<CollisionEnterEvent>(this, &DamageSystem::OnCollisions, subscriptions);
         }
 
-        void onCollision(CollisionEvent& event) {
-            Entity a = event.a;
-            Entity b = event.b;
-            Logger::Log("The damage system received a collision event between entities " + std::to_string(a.GetId()) + " and " + std::to_string(b.GetId()));
+        // All of the frame's new collisions at once, ordered by entity. Kill() is deferred, so a projectile
+        // touching several targets in the same frame hits every one of them, as with immediate events.
+        void OnCollisions(EventSpan<CollisionEnterEvent> events) {
+            for (const auto& event: events) {
+                Entity a = event.a;
+                Entity b = event.b;
+                Logger::Log("The damage system received a collision event between entities " + std::to_string(a.GetId()) + " and " + std::to_string(b.GetId()));
 
-            if (a.BelongsToGroup("projectiles") && b.HasTag("player")) {
-                OnProjectileHitsPlayer(a, b);
-            }
+                if (a.BelongsToGroup("projectiles") && b.HasTag("player")) {
+                    OnProjectileHitsPlayer(a, b);
+                }
 
-            if (b.BelongsToGroup("projectiles") && a.HasTag("player")) {
-                OnProjectileHitsPlayer(b, a);
-            }
+                if (b.BelongsToGroup("projectiles") && a.HasTag("player")) {
+                    OnProjectileHitsPlayer(b, a);
+                }
 
-            if (a.BelongsToGroup("projectiles") && b.BelongsToGroup("enemies")) {
-                OnProjectileHitsEnemy(a, b);
-            }
-            
-            if (b.BelongsToGroup("projectiles") && a.BelongsToGroup("enemies")) {
-                OnProjectileHitsEnemy(b, a);
+                if (a.BelongsToGroup("projectiles") && b.BelongsToGroup("enemies")) {
+                    OnProjectileHitsEnemy(a, b);
+                }
+
+                if (b.BelongsToGroup("projectiles") && a.BelongsToGroup("enemies")) {
+                    OnProjectileHitsEnemy(b, a);
+                }
             }
         }
 
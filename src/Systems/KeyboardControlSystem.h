@@ -11,6 +11,9 @@
 #include <SDL2/SDL.h>
 
 class KeyboardControlSystem: public System {
+    private:
+        EventSubscriptions subscriptions;
+
     public:
         KeyboardControlSystem() {
             RequireComponent<KeyboardControlledComponent>();
@@ -18,8 +21,9 @@ class KeyboardControlSystem: public System {
             RequireComponent<RigidBodyComponent>();
         }
 
-        void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus) {
-            eventBus->SubscribeToEvent<KeyPressedEvent>(this, &KeyboardControlSystem::OnKeyPressed);
+        void SubscribeToEvents(const std::unique_ptr<EventBus>& eventBus) {
+            subscriptions.UnsubscribeAll();
+            eventBus->SubscribeToEvent<KeyPressedEvent>(this, &KeyboardControlSystem::OnKeyPressed, subscriptions);
         }
 
         void OnKeyPressed(KeyPressedEvent& event) {
@@ -3,23 +3,27 @@
 
 #include "../ECS/ECS.h"
 #include "../EventBus/EventBus.h"
-#include "../Events/CollisionEvent.h"
+#include "../Events/CollisionEnterEvent.h"
 #include "../Components/TransformComponent.h"
 #include "../Components/RigidBodyComponent.h"
 #include "../Components/SpriteComponent.h"
 
 class MovementSystem: public System {
+    private:
+        EventSubscriptions subscriptions;
+
     public:
         MovementSystem() {
             RequireComponent<TransformComponent>();
-            RequireComponent<RigidBodyComponent>();
+            RequireComponent<RigidBodyComponent>(ACCESS_READ);
         }
 
         void SubscribeToEvents(const std::unique_ptr<EventBus>& eventBus) {
-            eventBus->SubscribeToEvent<CollisionEvent>(this, &MovementSystem::OnCollision);
+            subscriptions.UnsubscribeAll();
+            eventBus->SubscribeToEvent<CollisionEnterEvent>(this, &MovementSystem::OnCollision, subscriptions);
         }
         
-        void OnCollision(CollisionEvent& event) {
+        void OnCollision(CollisionEnterEvent& event) {
             Entity a = event.a;
             Entity b = event.b;
             Logger::Log("Collision event emitted: " + std::to_string(a.GetId()) + " and " + std::to_string(b.GetId()));
@@ -50,11 +54,9 @@ class MovementSystem: public System {
             }
         }
 
-        void Update(double deltaTime) {
-            for (auto entity: GetSystemEntities()) {
-                auto& transform = entity.GetComponent<TransformComponent>();
-                const auto rigidbody = entity.GetComponent<RigidBodyComponent>();
-
+        // Every entity only touches its own transform, so the loop is split across the thread pool
+        void Update(double deltaTime, const std::unique_ptr<Registry>& registry, ThreadPool& threadPool) {
+            registry->GetView<TransformComponent, RigidBodyComponent>().ParallelForEach(threadPool, [&](Entity entity, TransformComponent& transform, const RigidBodyComponent& rigidbody) {
                 transform.position.x += rigidbody.velocity.x * deltaTime; 
                 transform.position.y += rigidbody.velocity.y * deltaTime; 
 
@@ -79,7 +81,7 @@ class MovementSystem: public System {
                 if (isEntityOutsideMap && !entity.HasTag("player")) {
                     entity.Kill();
                 }
-            }
+            });
         }
 };
 
@@ -10,18 +10,31 @@
 #include "../Components/SpriteComponent.h"
 #include "../Components/BoxColliderComponent.h"
 #include "../Components/ProjectileComponent.h"
+#include "../Components/CameraFollowComponent.h"
 #include <glm/glm.hpp>
 #include <SDL2/SDL.h>
 
 class ProjectileEmitSystem: public System {
+    private:
+        EventSubscriptions subscriptions;
+
     public:
         ProjectileEmitSystem() {
             RequireComponent<ProjectileEmitterComponent>();
-            RequireComponent<TransformComponent>();
+            RequireComponent<TransformComponent>(ACCESS_READ);
+            ReadsComponent<SpriteComponent>();
+            ReadsComponent<RigidBodyComponent>();
+            ReadsComponent<CameraFollowComponent>();
+        }
+
+        // Friendly projectiles can only hit enemies, the others only the player
+        static CollisionFilter GetProjectileFilter(const ProjectileEmitterComponent& projectileEmitter) {
+            return CollisionFilter(COLLISION_LAYER_PROJECTILE, projectileEmitter.isFriendly ? COLLISION_LAYER_ENEMY : COLLISION_LAYER_PLAYER);
         }
 
-        void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus) {
-            eventBus->SubscribeToEvent<KeyPressedEvent>(this, &ProjectileEmitSystem::OnKeyPressed);
+        void SubscribeToEvents(const std::unique_ptr<EventBus>& eventBus) {
+            subscriptions.UnsubscribeAll();
+            eventBus->SubscribeToEvent<KeyPressedEvent>(this, &ProjectileEmitSystem::OnKeyPressed, subscriptions);
         }
 
         void OnKeyPressed(KeyPressedEvent& event) {
@@ -49,13 +62,15 @@ class ProjectileEmitSystem: public System {
                         projectileVelocity.x = projectileEmitter.projectileVelocity.x * directionX;
                         projectileVelocity.y = projectileEmitter.projectileVelocity.y * directionY;
                     
-                        Entity projectile = entity.registry->CreateEntity();
-                        projectile.Group("projectiles");
-                        projectile.AddComponent<TransformComponent>(projectilePosition, glm::vec2(1.0, 1.0), 0.0);
-                        projectile.AddComponent<RigidBodyComponent>(projectileVelocity);
-                        projectile.AddComponent<SpriteComponent>("bullet-texture", 4, 4, 4);
-                        projectile.AddComponent<BoxColliderComponent>(4, 4);
-                        projectile.AddComponent<ProjectileComponent>(projectileEmitter.isFriendly, projectileEmitter.hitPercentDamage, projectileEmitter.projectileDuration);
+                        // Spawn through the command buffer so the system entities and pools stay put while iterating
+                        auto& commands = entity.registry->GetCommandBuffer();
+                        Entity projectile = commands.CreateEntity();
+                        commands.Group(projectile, "projectiles");
+                        commands.AddComponent<TransformComponent>(projectile, projectilePosition, glm::vec2(1.0, 1.0), 0.0);
+                        commands.AddComponent<RigidBodyComponent>(projectile, projectileVelocity);
+                        commands.AddComponent<SpriteComponent>(projectile, "bullet-texture", 4, 4, 4);
+                        commands.AddComponent<BoxColliderComponent>(projectile, 4, 4, glm::vec2(0), GetProjectileFilter(projectileEmitter), true);
+                        commands.AddComponent<ProjectileComponent>(projectile, projectileEmitter.isFriendly, projectileEmitter.hitPercentDamage, projectileEmitter.projectileDuration);
                     }
                 }
             }
@@ -79,13 +94,14 @@ class ProjectileEmitSystem: public System {
                         projectilePosition.y += transform.scale.y * sprite.height / 2;
                     }
 
-                    Entity projectile = registry->CreateEntity();
-                    projectile.Group("projectiles");
-                    projectile.AddComponent<TransformComponent>(projectilePosition, glm::vec2(1.0, 1.0), 0.0);
-                    projectile.AddComponent<RigidBodyComponent>(projectileEmitter.projectileVelocity);
-                    projectile.AddComponent<SpriteComponent>("bullet-texture", 4, 4, 4);
-                    projectile.AddComponent<BoxColliderComponent>(4, 4);
-                    projectile.AddComponent<ProjectileComponent>(projectileEmitter.isFriendly, projectileEmitter.hitPercentDamage, projectileEmitter.projectileDuration);
+                    auto& commands = registry->GetCommandBuffer();
+                    Entity projectile = commands.CreateEntity();
+                    commands.Group(projectile, "projectiles");
+                    commands.AddComponent<TransformComponent>(projectile, projectilePosition, glm::vec2(1.0, 1.0), 0.0);
+                    commands.AddComponent<RigidBodyComponent>(projectile, projectileEmitter.projectileVelocity);
+                    commands.AddComponent<SpriteComponent>(projectile, "bullet-texture", 4, 4, 4);
+                    commands.AddComponent<BoxColliderComponent>(projectile, 4, 4, glm::vec2(0), GetProjectileFilter(projectileEmitter), true);
+                    commands.AddComponent<ProjectileComponent>(projectile, projectileEmitter.isFriendly, projectileEmitter.hitPercentDamage, projectileEmitter.projectileDuration);
 
                     projectileEmitter.lastEmissionTime = SDL_GetTicks();
                 }
@@ -8,6 +8,10 @@
 #include "../Components/BoxColliderComponent.h"
 #include "../Components/ProjectileEmitterComponent.h"
 #include "../Components/HealthComponent.h"
+#include "../Profiler/AllocationCounter.h"
+#include "../Scheduler/SystemScheduler.h"
+#include "../Systems/CollisionSystem.h"
+#include "../Systems/RenderSystem.h"
 #include <imgui/imgui.h>
 #include <imgui/imgui_sdl.h>
 
@@ -15,7 +19,7 @@ class RenderGUISystem: public System {
     public:
         RenderGUISystem() = default;
 
-        void Update(const std::unique_ptr<Registry>& registry, const SDL_Rect& camera) {
+        void Update(const std::unique_ptr<Registry>& registry, const SDL_Rect& camera, const std::unique_ptr<SystemScheduler>& scheduler) {
             ImGui::NewFrame();
 
             // Display a window to customize and create new enemies
@@ -84,7 +88,7 @@ class RenderGUISystem: public System {
                     enemy.AddComponent<TransformComponent>(glm::vec2(posX, posY), glm::vec2(scaleX, scaleY), glm::degrees(rotation));
                     enemy.AddComponent<RigidBodyComponent>(glm::vec2(velX, velY));
                     enemy.AddComponent<SpriteComponent>(sprites[selectedSpriteIndex], 32, 32, 2);
-                    enemy.AddComponent<BoxColliderComponent>(25, 20, glm::vec2(5, 5));
+                    enemy.AddComponent<BoxColliderComponent>(25, 20, glm::vec2(5, 5), CollisionFilter(COLLISION_LAYER_ENEMY, COLLISION_LAYER_PROJECTILE | COLLISION_LAYER_OBSTACLE));
                     double projVelX = cos(projAngle) * projSpeed; // convert from angle-speed to x-value
                     double projVelY = sin(projAngle) * projSpeed; // convert from angle-speed to y-value
                     enemy.AddComponent<ProjectileEmitterComponent>(glm::vec2(projVelX, projVelY), projRepeat * 1000, projDuration * 1000, 10, false);
@@ -110,9 +114,58 @@ class RenderGUISystem: public System {
                     ImGui::GetIO().MousePos.x + camera.x,
                     ImGui::GetIO().MousePos.y + camera.y
                 );
+                ImGui::Text("Heap allocations last frame: %ld", AllocationCounter::GetLastFrameAllocations());
             }
             ImGui::End();
 
+            // Display how long every scheduled system took last frame
+            if (ImGui::Begin("System timings")) {
+                bool isDeterministic = scheduler->IsDeterministic();
+                if (ImGui::Checkbox("deterministic (single thread)", &isDeterministic)) {
+                    scheduler->SetDeterministic(isDeterministic);
+                }
+                ImGui::Separator();
+                for (const auto& timing: scheduler->GetTimings()) {
+                    ImGui::Text("wave %d  %-28s %.3f ms", timing.wave, timing.name.c_str(), timing.milliseconds);
+                }
+            }
+            ImGui::End();
+
+            // Compare batched and per-sprite rendering
+            if (registry->HasSystem<RenderSystem>()) {
+                if (ImGui::Begin("Rendering")) {
+                    auto& renderSystem = registry->GetSystem<RenderSystem>();
+                    bool isBatched = renderSystem.IsBatched();
+                    if (ImGui::Checkbox("batch sprites", &isBatched)) {
+                        renderSystem.SetBatched(isBatched);
+                    }
+                    ImGui::Text("Sprites: %d, draw calls: %d", renderSystem.GetNumDrawnSprites(), renderSystem.GetNumDrawCalls());
+                }
+                ImGui::End();
+            }
+
+            // Switch the collision broad phase at runtime to compare the algorithms
+            if (registry->HasSystem<CollisionSystem>()) {
+                if (ImGui::Begin("Collision")) {
+                    auto& collisionSystem = registry->GetSystem<CollisionSystem>();
+                    const char* broadPhases[] = {"spatial hash", "sweep and prune"};
+                    int selectedBroadPhase = collisionSystem.GetBroadPhase();
+                    if (ImGui::Combo("broad phase", &selectedBroadPhase, broadPhases, IM_ARRAYSIZE(broadPhases))) {
+                        collisionSystem.SetBroadPhase(static_cast<BroadPhase>(selectedBroadPhase));
+                    }
+                    ImGui::Text("Dynamic colliders: %d, static colliders: %d", collisionSystem.GetNumDynamicColliders(), collisionSystem.GetNumStaticColliders());
+                    ImGui::Text("Static grid rebuilds: %d", collisionSystem.GetNumStaticRebuilds());
+                    ImGui::Text("Overlapping pairs last frame: %d", collisionSystem.GetNumOverlappingPairs());
+                    ImGui::Text("Swept fast colliders: %d", collisionSystem.GetNumSweptColliders());
+                    ImGui::Text("Active contacts: %d", collisionSystem.GetNumContacts());
+                    bool isStayEventEnabled = collisionSystem.IsStayEventEnabled();
+                    if (ImGui::Checkbox("emit stay events", &isStayEventEnabled)) {
+                        collisionSystem.SetStayEventEnabled(isStayEventEnabled);
+                    }
+                }
+                ImGui::End();
+            }
+
             ImGui::Render();
             ImGuiSDL::Render(ImGui::GetDrawData());
         }
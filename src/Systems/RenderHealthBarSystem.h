@@ -16,12 +16,8 @@ class RenderHealthBarSystem: public System {
             RequireComponent<HealthComponent>();
         }
 
-        void Update(SDL_Renderer* renderer, const std::unique_ptr<AssetStore>& assetStore, const SDL_Rect& camera) {
-            for (auto entity: GetSystemEntities()) {
-                const auto transform = entity.GetComponent<TransformComponent>();
-                const auto sprite = entity.GetComponent<SpriteComponent>();
-                const auto health = entity.GetComponent<HealthComponent>();
-
+        void Update(SDL_Renderer* renderer, const std::unique_ptr<AssetStore>& assetStore, const SDL_Rect& camera, const std::unique_ptr<Registry>& registry) {
+            registry->GetView<TransformComponent, SpriteComponent, HealthComponent>().Each([&](Entity entity, const TransformComponent& transform, const SpriteComponent& sprite, const HealthComponent& health) {
                 SDL_Color healthBarColor = {255, 255, 255};
 
                 if (health.healthPercentage >= 0 && health.healthPercentage < 40) {
@@ -66,7 +62,7 @@ class RenderHealthBarSystem: public System {
                 SDL_RenderCopy(renderer, texture, NULL, &healthBarTextRectangle);
 
                 SDL_DestroyTexture(texture);
-            }
+            });
         }
 };
 
@@ -5,53 +5,34 @@
 #include "../Components/TransformComponent.h"
 #include "../Components/SpriteComponent.h"
 #include "../AssetStore/AssetStore.h"
+#include "../Renderer/SpriteBatch.h"
 #include <SDL2/SDL.h>
 
 class RenderSystem: public System {
+    private:
+        SpriteBatch spriteBatch;
+
     public:
         RenderSystem() {
             RequireComponent<TransformComponent>();
             RequireComponent<SpriteComponent>();
         }
 
-        void Update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore, SDL_Rect& camera) {
-            struct RenderableEntity {
-                TransformComponent transformComponent;
-                SpriteComponent spriteComponent;
-            };
-
-            std::vector<RenderableEntity> renderableEntities;
-
-            for (auto entity: GetSystemEntities()) {
-                RenderableEntity renderableEntity;
-                renderableEntity.spriteComponent = entity.GetComponent<SpriteComponent>();
-                renderableEntity.transformComponent = entity.GetComponent<TransformComponent>();
+        void Update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore, SDL_Rect& camera, const std::unique_ptr<Registry>& registry) {
+            spriteBatch.Begin();
 
+            registry->GetView<TransformComponent, SpriteComponent>().Each([&](Entity entity, const TransformComponent& transform, const SpriteComponent& sprite) {
                 bool isOutsideCameraView = (
-                    renderableEntity.transformComponent.position.x + (renderableEntity.transformComponent.scale.x * renderableEntity.spriteComponent.width) < camera.x ||
-                    renderableEntity.transformComponent.position.x > camera.x + camera.w ||
-                    renderableEntity.transformComponent.position.y + (renderableEntity.transformComponent.scale.y * renderableEntity.spriteComponent.height) < camera.y ||
-                    renderableEntity.transformComponent.position.y > camera.y + camera.h
+                    transform.position.x + (transform.scale.x * sprite.width) < camera.x ||
+                    transform.position.x > camera.x + camera.w ||
+                    transform.position.y + (transform.scale.y * sprite.height) < camera.y ||
+                    transform.position.y > camera.y + camera.h
                 );
 
-                if (isOutsideCameraView && !renderableEntity.spriteComponent.isFixed) {
-                    continue;
+                if (isOutsideCameraView && !sprite.isFixed) {
+                    return;
                 }
 
-                renderableEntities.emplace_back(renderableEntity);
-            }
-
-            std::sort(renderableEntities.begin(), renderableEntities.end(), 
-                [](const RenderableEntity& a, const RenderableEntity& b) {
-                    return a.spriteComponent.zIndex < b.spriteComponent.zIndex;
-            });
-            
-            for (auto entity: renderableEntities) {
-                const auto transform = entity.transformComponent;
-                const auto sprite = entity.spriteComponent;
-                
-                SDL_Rect srcRect = sprite.srcRect;
-
                 SDL_Rect dstRect = {
                     static_cast<int>(transform.position.x - (sprite.isFixed ? 0 : camera.x)),
                     static_cast<int>(transform.position.y - (sprite.isFixed ? 0 : camera.y)),
@@ -59,16 +40,34 @@ class RenderSystem: public System {
                     static_cast<int>(sprite.height * transform.scale.y)
                 };
 
-                SDL_RenderCopyEx(
-                    renderer,
+                spriteBatch.Add({
                     assetStore->GetTexture(sprite.assetId),
-                    &srcRect,
-                    &dstRect,
+                    sprite.srcRect,
+                    dstRect,
                     transform.rotation,
-                    NULL,
-                    sprite.flip
-                );
-            }
+                    sprite.flip,
+                    sprite.zIndex
+                });
+            });
+
+            spriteBatch.End(renderer);
+        }
+
+        // Draw sprites sharing a texture with one SDL_RenderGeometry call, or one SDL_RenderCopyEx each
+        void SetBatched(bool isBatched) {
+            spriteBatch.SetBatched(isBatched);
+        }
+
+        bool IsBatched() const {
+            return spriteBatch.IsBatched();
+        }
+
+        int GetNumDrawCalls() const {
+            return spriteBatch.GetNumDrawCalls();
+        }
+
+        int GetNumDrawnSprites() const {
+            return spriteBatch.GetNumDrawnSprites();
         }
 };
 
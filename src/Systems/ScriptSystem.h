@@ -7,6 +7,8 @@
 #include "../Components/RigidBodyComponent.h"
 #include "../Components/AnimationComponent.h"
 #include "../Components/ProjectileEmitterComponent.h"
+#include "../Game/LevelLoader.h"
+#include "./SpatialIndexSystem.h"
 #include <tuple>
 
 std::tuple<double, double> GetEntityPosition(Entity entity) {
@@ -81,13 +83,17 @@ class ScriptSystem: public System {
     public:
         ScriptSystem() {
             RequireComponent<ScriptComponent>();
+
+            // Lua isn't thread safe and scripts may touch any component
+            RunExclusively();
         }
 
-        void CreateLuaBindings(sol::state& lua) {
+        void CreateLuaBindings(sol::state& lua, SpatialIndexSystem& spatialIndex) {
             // Create the "entity" usertype so Lua knows what an entity is
             lua.new_usertype<Entity>(
                 "entity",
                 "get_id", &Entity::GetId,
+                "is_alive", &Entity::IsAlive,
                 "destroy", &Entity::Kill,
                 "has_tag", &Entity::HasTag,
                 "belongs_to_group", &Entity::BelongsToGroup
@@ -101,6 +107,34 @@ class ScriptSystem: public System {
             lua.set_function("set_rotation", SetEntityRotation);
             lua.set_function("set_projectile_velocity", SetProjectileVelocity);
             lua.set_function("set_animation_frame", SetEntityAnimationFrame);
+
+            // Spatial queries over every collider. Layers are optional collision layer names, e.g. "enemy"
+            // or { "enemy", "obstacle" }, and default to all. Raycast and nearest can skip one entity, e.g. the caller.
+            lua.set_function("query_aabb", [&spatialIndex](double x, double y, double width, double height, sol::object layers) {
+                return sol::as_table(spatialIndex.QueryAABB(x, y, width, height, LevelLoader::ParseCollisionLayers(layers, COLLISION_LAYER_ALL)));
+            });
+            lua.set_function("query_radius", [&spatialIndex](double x, double y, double radius, sol::object layers) {
+                return sol::as_table(spatialIndex.QueryRadius(x, y, radius, LevelLoader::ParseCollisionLayers(layers, COLLISION_LAYER_ALL)));
+            });
+            // Returns the entity hit and the point where the ray enters its collider, or nil
+            lua.set_function("raycast", [&spatialIndex](sol::this_state state, double x1, double y1, double x2, double y2, sol::object layers, sol::object ignored) {
+                Entity hitEntity(-1);
+                glm::vec2 hitPoint;
+                const Entity ignoredEntity = ignored.is<Entity>() ? ignored.as<Entity>() : Entity(-1);
+                if (!spatialIndex.Raycast(x1, y1, x2, y2, LevelLoader::ParseCollisionLayers(layers, COLLISION_LAYER_ALL), ignoredEntity, hitEntity, hitPoint)) {
+                    return std::make_tuple(sol::make_object(state, sol::lua_nil), sol::make_object(state, sol::lua_nil), sol::make_object(state, sol::lua_nil));
+                }
+                return std::make_tuple(sol::make_object(state, hitEntity), sol::make_object(state, hitPoint.x), sol::make_object(state, hitPoint.y));
+            });
+            // Returns the entity closest to the point and closer than max_distance, or nil
+            lua.set_function("nearest", [&spatialIndex](sol::this_state state, double x, double y, double maxDistance, sol::object layers, sol::object ignored) {
+                Entity nearest(-1);
+                const Entity ignoredEntity = ignored.is<Entity>() ? ignored.as<Entity>() : Entity(-1);
+                if (!spatialIndex.FindNearest(x, y, maxDistance, LevelLoader::ParseCollisionLayers(layers, COLLISION_LAYER_ALL), ignoredEntity, nearest)) {
+                    return sol::make_object(state, sol::lua_nil);
+                }
+                return sol::make_object(state, nearest);
+            });
         }
 
         void Update(double deltaTime, int elapsedTime) {
@@ -0,0 +1,116 @@
+#ifndef SPATIALINDEXSYSTEM_H
+#define SPATIALINDEXSYSTEM_H
+
+#include "../ECS/ECS.h"
+#include "../Components/TransformComponent.h"
+#include "../Components/BoxColliderComponent.h"
+#include "../Physics/AABB.h"
+#include "../Physics/SpatialIndex.h"
+#include <glm/glm.hpp>
+
+// Keeps a spatial index of every collider, so scripts can ask what is nearby without looping over all entities.
+// The index is rebuilt once per frame after movement; queries see positions as of that rebuild.
+class SpatialIndexSystem: public System {
+    private:
+        SpatialIndex spatialIndex;
+
+        // Reused between frames so rebuilding the index doesn't allocate
+        std::vector<Entity> indexedEntities;
+        std::vector<AABB> boxes;
+        std::vector<uint32_t> categories;
+        std::vector<int> items;
+
+        // Item of each indexed entity, or -1
+        // Vector index = entity id
+        std::vector<int> itemPerEntityId;
+
+        int GetItem(Entity entity) const {
+            const int entityId = entity.GetId();
+            if (entityId < 0 || entityId >= static_cast<int>(itemPerEntityId.size()) || itemPerEntityId[entityId] == -1) {
+                return -1;
+            }
+            const int item = itemPerEntityId[entityId];
+            return indexedEntities[item] == entity ? item : -1;
+        }
+
+        std::vector<Entity> GetItemEntities() const {
+            std::vector<Entity> entities;
+            entities.reserve(items.size());
+            for (int item: items) {
+                entities.push_back(indexedEntities[item]);
+            }
+            return entities;
+        }
+
+    public:
+        SpatialIndexSystem() {
+            RequireComponent<TransformComponent>(ACCESS_READ);
+            RequireComponent<BoxColliderComponent>(ACCESS_READ);
+        }
+
+        // Use about one map tile per cell
+        void SetCellSize(float cellSize) {
+            spatialIndex.SetCellSize(cellSize);
+        }
+
+        void Update(const std::unique_ptr<Registry>& registry) {
+            for (auto entity: indexedEntities) {
+                itemPerEntityId[entity.GetId()] = -1;
+            }
+            indexedEntities.clear();
+            boxes.clear();
+            categories.clear();
+
+            registry->GetView<TransformComponent, BoxColliderComponent>().Each([this](Entity entity, const TransformComponent& transform, const BoxColliderComponent& collider) {
+                if (entity.GetId() >= static_cast<int>(itemPerEntityId.size())) {
+                    itemPerEntityId.resize(entity.GetId() + 1, -1);
+                }
+                itemPerEntityId[entity.GetId()] = static_cast<int>(indexedEntities.size());
+                indexedEntities.push_back(entity);
+
+                const float x = transform.position.x + collider.offset.x;
+                const float y = transform.position.y + collider.offset.y;
+                boxes.emplace_back(x, y, x + collider.width, y + collider.height);
+                categories.push_back(collider.filter.category);
+            });
+
+            spatialIndex.Build(boxes, categories);
+        }
+
+        // Entities whose collider overlaps the rectangle and is on one of the layers
+        std::vector<Entity> QueryAABB(float x, float y, float width, float height, uint32_t layers) {
+            items.clear();
+            spatialIndex.QueryAABB(AABB(x, y, x + width, y + height), layers, items);
+            return GetItemEntities();
+        }
+
+        // Entities whose collider comes closer than radius to (x, y) and is on one of the layers
+        std::vector<Entity> QueryRadius(float x, float y, float radius, uint32_t layers) {
+            items.clear();
+            spatialIndex.QueryRadius(x, y, radius, layers, items);
+            return GetItemEntities();
+        }
+
+        // First collider on the layers crossed going from (x1, y1) to (x2, y2), skipping the ignored entity
+        bool Raycast(float x1, float y1, float x2, float y2, uint32_t layers, Entity ignored, Entity& hitEntity, glm::vec2& hitPoint) {
+            SpatialIndex::RaycastHit hit;
+            if (!spatialIndex.Raycast(x1, y1, x2, y2, layers, GetItem(ignored), hit)) {
+                return false;
+            }
+            hitEntity = indexedEntities[hit.item];
+            hitPoint = glm::vec2(hit.x, hit.y);
+            return true;
+        }
+
+        // Collider on the layers closest to (x, y) and closer than maxDistance, skipping the ignored entity
+        bool FindNearest(float x, float y, float maxDistance, uint32_t layers, Entity ignored, Entity& nearest) {
+            const int item = spatialIndex.FindNearest(x, y, maxDistance, layers, GetItem(ignored));
+            if (item == -1) {
+                return false;
+            }
+            nearest = indexedEntities[item];
+            return true;
+        }
+};
+
+#endif
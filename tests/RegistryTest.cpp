@@ -0,0 +1,63 @@
+// Registry test: component bookkeeping in both storage modes, checked without SDL or a renderer.
+// Build and run with `make test`.
+
+#include "../src/ECS/ECS.h"
+#include <cstdio>
+
+struct Health {
+    int value;
+};
+
+struct Armor {
+    int value;
+};
+
+// === Checks === //
+
+int numFailures = 0;
+
+void Check(bool condition, const char* description) {
+    if (!condition) {
+        std::printf("FAILED: %s\n", description);
+        numFailures++;
+    }
+}
+
+// Removing a component the entity doesn't own must leave every other entity's components alone
+void TestRemoveMissingComponent(StorageMode storageMode) {
+    Registry registry(storageMode);
+
+    Entity first = registry.CreateEntity();
+    Entity second = registry.CreateEntity();
+    first.AddComponent<Health>(Health{10});
+    second.AddComponent<Health>(Health{20});
+    registry.Update();
+
+    first.RemoveComponent<Armor>();
+    Entity third = registry.CreateEntity();
+    third.AddComponent<Health>(Health{30});
+    registry.Update();
+
+    Check(!first.HasComponent<Armor>(), "missing component stays missing");
+    Check(first.GetComponent<Health>().value == 10, "first entity keeps its own component");
+    Check(second.GetComponent<Health>().value == 20, "second entity keeps its own component");
+    Check(third.GetComponent<Health>().value == 30, "new entity gets its own component");
+
+    first.RemoveComponent<Health>();
+    first.RemoveComponent<Health>();
+    Check(!first.HasComponent<Health>(), "removed component is gone");
+    Check(second.GetComponent<Health>().value == 20, "second removal leaves the others alone");
+    Check(third.GetComponent<Health>().value == 30, "second removal leaves the last entity alone");
+}
+
+int main() {
+    TestRemoveMissingComponent(STORAGE_POOLS);
+    TestRemoveMissingComponent(STORAGE_ARCHETYPES);
+
+    if (numFailures > 0) {
+        std::printf("%d Registry checks failed\n", numFailures);
+        return 1;
+    }
+    std::printf("All Registry checks passed\n");
+    return 0;
+}
@@ -0,0 +1,176 @@
+// SpriteBatch test: the draw calls and vertices End() produces, checked without a renderer. The SDL
+// functions SpriteBatch calls are defined below and record what they were given, so only the SDL
+// headers are needed, not the library or a display. Build and run with `make test`.
+
+#include "../src/Renderer/SpriteBatch.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// === Recording SDL === //
+
+struct SDL_Texture {
+    int width;
+    int height;
+};
+
+struct SDL_Renderer {
+    int numCopies = 0;
+    int numGeometries = 0;
+    bool isGeometryFailing = false;
+    std::vector<SDL_Texture*> drawnTextures;
+    std::vector<SDL_Vertex> lastVertices;
+    std::vector<int> lastIndices;
+};
+
+int SDL_QueryTexture(SDL_Texture* texture, Uint32*, int*, int* width, int* height) {
+    *width = texture->width;
+    *height = texture->height;
+    return 0;
+}
+
+int SDL_RenderCopyEx(SDL_Renderer* renderer, SDL_Texture* texture, const SDL_Rect*, const SDL_Rect*, double, const SDL_Point*, SDL_RendererFlip) {
+    renderer->numCopies++;
+    renderer->drawnTextures.push_back(texture);
+    return 0;
+}
+
+#if SPRITEBATCH_HAS_GEOMETRY
+int SDL_RenderGeometry(SDL_Renderer* renderer, SDL_Texture* texture, const SDL_Vertex* vertices, int numVertices, const int* indices, int numIndices) {
+    if (renderer->isGeometryFailing) {
+        return -1;
+    }
+    renderer->numGeometries++;
+    renderer->drawnTextures.push_back(texture);
+    renderer->lastVertices.assign(vertices, vertices + numVertices);
+    renderer->lastIndices.assign(indices, indices + numIndices);
+    return 0;
+}
+#endif
+
+const char* SDL_GetError() {
+    return "geometry not supported";
+}
+
+// === Checks === //
+
+int numFailures = 0;
+
+void Check(bool condition, const char* description) {
+    if (!condition) {
+        std::printf("FAILED: %s\n", description);
+        numFailures++;
+    }
+}
+
+bool IsNear(float a, float b) {
+    return std::fabs(a - b) < 1e-3f;
+}
+
+SpriteDraw Sprite(SDL_Texture* texture, SDL_Rect srcRect, SDL_Rect dstRect, int zIndex, double rotation = 0, SDL_RendererFlip flip = SDL_FLIP_NONE) {
+    return {texture, srcRect, dstRect, rotation, flip, zIndex};
+}
+
+void TestPerSprite() {
+    SDL_Texture tileset = {320, 96};
+    SDL_Renderer renderer;
+    SpriteBatch spriteBatch;
+    spriteBatch.SetBatched(false);
+
+    spriteBatch.Begin();
+    spriteBatch.Add(Sprite(&tileset, {0, 0, 32, 32}, {0, 0, 32, 32}, 1));
+    spriteBatch.Add(Sprite(nullptr, {0, 0, 32, 32}, {0, 0, 32, 32}, 1));
+    spriteBatch.Add(Sprite(&tileset, {32, 0, 32, 32}, {32, 0, 32, 32}, 0));
+    spriteBatch.End(&renderer);
+
+    Check(renderer.numCopies == 2 && spriteBatch.GetNumDrawCalls() == 2, "per-sprite: one copy per sprite with a texture");
+    Check(spriteBatch.GetNumDrawnSprites() == 2, "per-sprite: sprites without a texture are skipped");
+}
+
+#if SPRITEBATCH_HAS_GEOMETRY
+void TestBatchesPerTextureRun() {
+    SDL_Texture tileset = {320, 96};
+    SDL_Texture tank = {32, 32};
+    SDL_Texture truck = {64, 32};
+    SDL_Renderer renderer;
+    SpriteBatch spriteBatch;
+
+    spriteBatch.Begin();
+    for (int i = 0; i < 100; i++) {
+        spriteBatch.Add(Sprite(&tileset, {32 * (i % 10), 0, 32, 32}, {32 * i, 0, 32, 32}, 0));
+    }
+    spriteBatch.Add(Sprite(&tank, {0, 0, 32, 32}, {10, 10, 32, 32}, 2));
+    spriteBatch.Add(Sprite(&truck, {0, 0, 32, 32}, {50, 50, 32, 32}, 1));
+    spriteBatch.Add(Sprite(&tileset, {0, 32, 32, 32}, {0, 0, 32, 32}, 3));
+    spriteBatch.End(&renderer);
+
+    Check(spriteBatch.GetNumDrawnSprites() == 103, "batched: every sprite is drawn");
+    Check(renderer.numGeometries == 4 && renderer.numCopies == 0 && spriteBatch.GetNumDrawCalls() == 4, "batched: one geometry call per run of a texture");
+    Check(renderer.drawnTextures == std::vector<SDL_Texture*>({&tileset, &truck, &tank, &tileset}), "batched: runs are drawn back to front");
+
+    // The last run is the z 3 tile, whose source rectangle is the second row of the tileset
+    const auto& vertices = renderer.lastVertices;
+    Check(vertices.size() == 4 && renderer.lastIndices.size() == 6, "batched: two triangles per sprite");
+    if (vertices.size() == 4) {
+        Check(IsNear(vertices[0].position.x, 0) && IsNear(vertices[0].position.y, 0) && IsNear(vertices[2].position.x, 32) && IsNear(vertices[2].position.y, 32), "batched: positions span the destination rectangle");
+        Check(IsNear(vertices[0].tex_coord.x, 0) && IsNear(vertices[0].tex_coord.y, 1.0f / 3) && IsNear(vertices[2].tex_coord.x, 0.1f) && IsNear(vertices[2].tex_coord.y, 2.0f / 3), "batched: texture coordinates span the source rectangle");
+    }
+}
+
+void TestRotationAndFlip() {
+    SDL_Texture tank = {32, 32};
+    SDL_Renderer renderer;
+    SpriteBatch spriteBatch;
+
+    spriteBatch.Begin();
+    spriteBatch.Add(Sprite(&tank, {0, 0, 32, 32}, {10, 10, 32, 20}, 0, 90, SDL_FLIP_HORIZONTAL));
+    spriteBatch.End(&renderer);
+
+    // Rotated clockwise around the center (26, 20), the top left corner (-16, -10) goes to (10, -16)
+    const auto& vertices = renderer.lastVertices;
+    Check(vertices.size() == 4, "rotation: one quad");
+    if (vertices.size() == 4) {
+        Check(IsNear(vertices[0].position.x, 36) && IsNear(vertices[0].position.y, 4), "rotation: corners turn clockwise around the center");
+        Check(IsNear(vertices[0].tex_coord.x, 1) && IsNear(vertices[1].tex_coord.x, 0), "flip: texture coordinates are mirrored horizontally");
+    }
+}
+
+void TestFallbackWhenGeometryFails() {
+    SDL_Texture tileset = {320, 96};
+    SDL_Texture tank = {32, 32};
+    SDL_Renderer renderer;
+    renderer.isGeometryFailing = true;
+    SpriteBatch spriteBatch;
+
+    spriteBatch.Begin();
+    for (int i = 0; i < 5; i++) {
+        spriteBatch.Add(Sprite(&tileset, {0, 0, 32, 32}, {0, 0, 32, 32}, 0));
+    }
+    spriteBatch.Add(Sprite(&tank, {0, 0, 32, 32}, {0, 0, 32, 32}, 1));
+    spriteBatch.End(&renderer);
+
+    Check(!spriteBatch.IsBatched(), "fallback: batching turns itself off");
+    Check(renderer.numCopies == 6 && spriteBatch.GetNumDrawCalls() == 6, "fallback: the frame is still drawn, one sprite at a time");
+
+    spriteBatch.SetBatched(true);
+    Check(spriteBatch.IsBatched(), "fallback: batching can be turned back on");
+}
+#endif
+
+int main() {
+    TestPerSprite();
+#if SPRITEBATCH_HAS_GEOMETRY
+    TestBatchesPerTextureRun();
+    TestRotationAndFlip();
+    TestFallbackWhenGeometryFails();
+#else
+    std::printf("SDL %d.%d.%d has no SDL_RenderGeometry, only the per-sprite path is tested\n", SDL_MAJOR_VERSION, SDL_MINOR_VERSION, SDL_PATCHLEVEL);
+#endif
+
+    if (numFailures > 0) {
+        std::printf("%d SpriteBatch checks failed\n", numFailures);
+        return 1;
+    }
+    std::printf("All SpriteBatch checks passed\n");
+    return 0;
+}